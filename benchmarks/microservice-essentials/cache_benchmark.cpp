@@ -0,0 +1,438 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <microservice-essentials/performance/clock-cache.h>
+#include <microservice-essentials/performance/thread-local-cache.h>
+#include <microservice-essentials/performance/w-tiny-lfu-cache.h>
+#include <random>
+#include <string>
+#include <thread>
+#include <utilities/allocation-counter.h>
+#include <vector>
+
+namespace
+{
+
+const std::size_t key_count = 1024;
+const std::size_t operations_per_thread = 50000;
+
+std::vector<std::string> create_keys()
+{
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < key_count; ++i)
+  {
+    keys.push_back("/api/starships/" + std::to_string(i) + "/?format=json");
+  }
+  return keys;
+}
+
+mse::Cache::Element create_element()
+{
+  // roughly the size of a star ship's properties
+  return mse::Cache::Element{std::string(512, 'x'), mse::Status::OK, mse::Cache::Clock::now()};
+}
+
+// returns the number of million operations per second of a 90% read / 10% write workload
+double measure_throughput(mse::Cache& cache, std::size_t thread_count, bool get_shared)
+{
+  const std::vector<std::string> keys = create_keys();
+  for (const std::string& key : keys)
+  {
+    cache.Insert(key, create_element());
+  }
+
+  std::atomic<bool> start = false;
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < thread_count; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      std::minstd_rand random(static_cast<std::minstd_rand::result_type>(t + 1));
+      const mse::Cache::Element element = create_element();
+      std::size_t hits = 0;
+      while (!start)
+      {
+        std::this_thread::yield();
+      }
+      for (std::size_t i = 0; i < operations_per_thread; ++i)
+      {
+        const std::string& key = keys[random() % keys.size()];
+        if (random() % 10 == 0)
+        {
+          cache.Insert(key, element);
+        }
+        else if (get_shared)
+        {
+          hits += cache.GetShared(key) != nullptr;
+        }
+        else
+        {
+          hits += mse::Cache::IsValid(cache.Get(key));
+        }
+      }
+      (void)hits;
+    });
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  start = true;
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  const std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start_time;
+  return static_cast<double>(thread_count * operations_per_thread) / duration.count();
+}
+
+// returns the number of million GetShared calls per second for a few hot keys that are never written, e.g. constant
+// responses
+double measure_hot_read_throughput(mse::Cache& cache, std::size_t thread_count)
+{
+  const std::vector<std::string> keys = {"/api/starships", "/api/planets", "/api/people", "/api/films"};
+  for (const std::string& key : keys)
+  {
+    cache.Insert(key, create_element());
+  }
+
+  std::atomic<bool> start = false;
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < thread_count; ++t)
+  {
+    threads.emplace_back([&]() {
+      std::size_t hits = 0;
+      while (!start)
+      {
+        std::this_thread::yield();
+      }
+      for (std::size_t i = 0; i < operations_per_thread; ++i)
+      {
+        hits += cache.GetShared(keys[i % keys.size()]) != nullptr;
+      }
+      (void)hits;
+    });
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  start = true;
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  const std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start_time;
+  return static_cast<double>(thread_count * operations_per_thread) / duration.count();
+}
+
+// returns the number of million items per second that are looked up in batches, e.g. the star ships of a list
+double measure_batch_read_throughput(mse::Cache& cache, std::size_t thread_count, std::size_t batch_size,
+                                     bool get_many)
+{
+  const std::vector<std::string> keys = create_keys();
+  for (const std::string& key : keys)
+  {
+    cache.Insert(key, create_element());
+  }
+
+  std::atomic<bool> start = false;
+  std::vector<std::thread> threads;
+  const std::size_t batch_count = operations_per_thread / batch_size;
+  for (std::size_t t = 0; t < thread_count; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      std::minstd_rand random(static_cast<std::minstd_rand::result_type>(t + 1));
+      std::vector<std::string> batch(batch_size);
+      std::size_t hits = 0;
+      while (!start)
+      {
+        std::this_thread::yield();
+      }
+      for (std::size_t i = 0; i < batch_count; ++i)
+      {
+        for (std::string& key : batch)
+        {
+          key = keys[random() % keys.size()];
+        }
+        if (get_many)
+        {
+          for (const std::shared_ptr<const mse::Cache::Element>& element : cache.GetMany(batch))
+          {
+            hits += element != nullptr;
+          }
+        }
+        else
+        {
+          for (const std::string& key : batch)
+          {
+            hits += cache.GetShared(key) != nullptr;
+          }
+        }
+      }
+      (void)hits;
+    });
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  start = true;
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  const std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start_time;
+  return static_cast<double>(thread_count * batch_count * batch_size) / duration.count();
+}
+
+// keys of a trace with zipf distributed popularity, i.e. the i-th most popular key is requested with a probability
+// proportional to 1/i^exponent
+std::vector<std::string> create_zipf_trace(std::size_t request_count, std::size_t distinct_key_count, double exponent,
+                                           std::minstd_rand& random)
+{
+  std::vector<double> cumulative_weights;
+  double sum = 0.0;
+  for (std::size_t i = 1; i <= distinct_key_count; ++i)
+  {
+    sum += 1.0 / std::pow(static_cast<double>(i), exponent);
+    cumulative_weights.push_back(sum);
+  }
+
+  std::uniform_real_distribution<double> distribution(0.0, sum);
+  std::vector<std::string> trace;
+  for (std::size_t i = 0; i < request_count; ++i)
+  {
+    const auto it = std::lower_bound(cumulative_weights.begin(), cumulative_weights.end(), distribution(random));
+    trace.push_back("/api/starships/" + std::to_string(it - cumulative_weights.begin()));
+  }
+  return trace;
+}
+
+// zipf trace that is interrupted by scans over keys that are only requested once (e.g. bots walking ids)
+std::vector<std::string> create_scan_trace(std::size_t request_count, std::size_t distinct_key_count, double exponent,
+                                           std::size_t scan_length, std::minstd_rand& random)
+{
+  const std::vector<std::string> zipf_trace = create_zipf_trace(request_count, distinct_key_count, exponent, random);
+  std::vector<std::string> trace;
+  std::size_t scanned_key_count = 0;
+  for (std::size_t i = 0; i < zipf_trace.size(); ++i)
+  {
+    trace.push_back(zipf_trace[i]);
+    if (i % (4 * scan_length) == 0)
+    {
+      for (std::size_t j = 0; j < scan_length; ++j)
+      {
+        trace.push_back("/api/starships/scanned/" + std::to_string(scanned_key_count++));
+      }
+    }
+  }
+  return trace;
+}
+
+// replays the trace like the CachingRequestHook does: insert on cache miss
+double measure_hit_ratio(mse::Cache& cache, const std::vector<std::string>& trace)
+{
+  const mse::Cache::Element element{0, mse::Status::OK, mse::Cache::Clock::now()};
+  std::size_t hits = 0;
+  for (const std::string& key : trace)
+  {
+    if (cache.GetShared(key) != nullptr)
+    {
+      ++hits;
+    }
+    else
+    {
+      cache.Insert(key, element);
+    }
+  }
+  return static_cast<double>(hits) / static_cast<double>(trace.size());
+}
+
+} // namespace
+
+TEST_CASE("Cache throughput with 90% reads and 10% writes", "[benchmark][cache]")
+{
+  std::cout << "million operations per second" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(24) << "1 shard, Get" << std::setw(24) << "16 shards, Get"
+            << std::setw(24) << "16 shards, GetShared" << std::endl;
+  for (std::size_t thread_count : {1, 2, 4, 8, 16, 32, 64})
+  {
+    mse::UnorderedMapCache single_shard_cache(1);
+    mse::UnorderedMapCache sharded_cache(16);
+    mse::UnorderedMapCache shared_sharded_cache(16);
+    std::cout << std::setw(8) << thread_count << std::fixed << std::setprecision(2) << std::setw(24)
+              << measure_throughput(single_shard_cache, thread_count, false) << std::setw(24)
+              << measure_throughput(sharded_cache, thread_count, false) << std::setw(24)
+              << measure_throughput(shared_sharded_cache, thread_count, true) << std::endl;
+  }
+}
+
+TEST_CASE("Bounded cache throughput with 90% reads and 10% writes", "[benchmark][cache]")
+{
+  std::cout << "million operations per second (capacity for all keys)" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(24) << "LRUCache" << std::setw(24) << "ClockCache" << std::endl;
+  for (std::size_t thread_count : {1, 2, 4, 8, 16, 32, 64})
+  {
+    mse::LRUCache lru_cache(std::make_shared<mse::UnorderedMapCache>(), key_count);
+    mse::ClockCache clock_cache(key_count);
+    std::cout << std::setw(8) << thread_count << std::fixed << std::setprecision(2) << std::setw(24)
+              << measure_throughput(lru_cache, thread_count, true) << std::setw(24)
+              << measure_throughput(clock_cache, thread_count, true) << std::endl;
+  }
+}
+
+TEST_CASE("Hot cache hit throughput", "[benchmark][cache]")
+{
+  std::cout << "million hits per second on 4 hot keys" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(24) << "UnorderedMapCache" << std::setw(24)
+            << "ThreadLocalCache" << std::setw(24) << "ClockCache" << std::endl;
+  for (std::size_t thread_count : {1, 2, 4, 8, 16, 32, 64})
+  {
+    mse::UnorderedMapCache shared_cache(16);
+    mse::ThreadLocalCache thread_local_cache(std::make_shared<mse::UnorderedMapCache>(16));
+    mse::ClockCache clock_cache(16);
+    std::cout << std::setw(8) << thread_count << std::fixed << std::setprecision(2) << std::setw(24)
+              << measure_hot_read_throughput(shared_cache, thread_count) << std::setw(24)
+              << measure_hot_read_throughput(thread_local_cache, thread_count) << std::setw(24)
+              << measure_hot_read_throughput(clock_cache, thread_count) << std::endl;
+  }
+}
+
+TEST_CASE("Batch cache lookup throughput", "[benchmark][cache]")
+{
+  const std::size_t batch_size = 64;
+  std::cout << "million items per second in batches of " << batch_size << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(24) << "GetShared per item" << std::setw(24) << "GetMany"
+            << std::endl;
+  for (std::size_t thread_count : {1, 2, 4, 8, 16, 32, 64})
+  {
+    mse::UnorderedMapCache cache(16);
+    std::cout << std::setw(8) << thread_count << std::fixed << std::setprecision(2) << std::setw(24)
+              << measure_batch_read_throughput(cache, thread_count, batch_size, false) << std::setw(24)
+              << measure_batch_read_throughput(cache, thread_count, batch_size, true) << std::endl;
+  }
+}
+
+TEST_CASE("Cache hit", "[benchmark][cache]")
+{
+  mse::UnorderedMapCache cache;
+  cache.Insert("key", create_element());
+
+  const std::size_t get_allocations = mse_benchmark::CountAllocations([&]() { cache.Get("key"); });
+  const std::size_t get_shared_allocations = mse_benchmark::CountAllocations([&]() { cache.GetShared("key"); });
+  std::cout << "allocations per cache hit: Get " << get_allocations << ", GetShared " << get_shared_allocations
+            << std::endl;
+  CHECK(get_shared_allocations == 0);
+}
+
+TEST_CASE("Caching request hook hit with a large response", "[benchmark][cache]")
+{
+  const std::string response(256 * 1024, 'x'); // roughly the size of a serialized list of star ships
+  const std::size_t hit_count = 1000;
+  std::shared_ptr<mse::UnorderedMapCache> cache = std::make_shared<mse::UnorderedMapCache>();
+  mse::Context context;
+
+  std::string object;
+  mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache).WithKey("copied").WithCachedObject(object));
+  hook.Process(
+      [&](mse::Context&) {
+        object = response;
+        return mse::Status::OK;
+      },
+      context);
+
+  std::shared_ptr<const std::string> shared_object;
+  mse::CachingRequestHook shared_hook(
+      mse::CachingRequestHook::Parameters(cache).WithKey("shared").WithCachedObject(shared_object));
+  shared_hook.Process(
+      [&](mse::Context&) {
+        shared_object = std::make_shared<const std::string>(response);
+        return mse::Status::OK;
+      },
+      context);
+
+  auto measure = [&](mse::CachingRequestHook& hook) {
+    const auto start_time = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < hit_count; ++i)
+    {
+      hook.Process([](mse::Context&) { return mse::Status::OK; }, context);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count() /
+           static_cast<double>(hit_count);
+  };
+  auto no_op = [](mse::Context&) { return mse::Status::OK; };
+  const std::size_t copied_allocations = mse_benchmark::CountAllocations([&]() { hook.Process(no_op, context); });
+  const std::size_t shared_allocations =
+      mse_benchmark::CountAllocations([&]() { shared_hook.Process(no_op, context); });
+
+  std::cout << "cache hit with a 256 KiB response: copied object " << std::fixed << std::setprecision(2)
+            << measure(hook) << "us (" << copied_allocations << " allocations), shared object "
+            << measure(shared_hook) << "us (" << shared_allocations << " allocations)" << std::endl;
+  CHECK(shared_allocations == 0);
+}
+
+TEST_CASE("Caching request hook hit with a composed key", "[benchmark][cache]")
+{
+  const std::size_t hit_count = 100000;
+  std::shared_ptr<mse::UnorderedMapCache> cache = std::make_shared<mse::UnorderedMapCache>();
+  mse::Context context;
+  const std::int64_t id = 4242;
+  int object = 0;
+  auto no_op = [](mse::Context&) { return mse::Status::OK; };
+
+  mse::CachingRequestHook generated_key_hook(
+      mse::CachingRequestHook::Parameters(cache)
+          .WithKeyGenerator([&id]() { return "/api/starships/" + std::to_string(id) + "/?format=json"; })
+          .WithCachedObject(object));
+  mse::CachingRequestHook composed_key_hook(mse::CachingRequestHook::Parameters(cache)
+                                                .WithKeyFrom("/api/starships", id, "?format=json")
+                                                .WithCachedObject(object));
+  generated_key_hook.Process(no_op, context);
+  composed_key_hook.Process(no_op, context);
+
+  auto measure = [&](mse::CachingRequestHook& hook) {
+    const auto start_time = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < hit_count; ++i)
+    {
+      hook.Process(no_op, context);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_time).count() /
+           static_cast<double>(hit_count);
+  };
+  const std::size_t generated_key_allocations =
+      mse_benchmark::CountAllocations([&]() { generated_key_hook.Process(no_op, context); });
+  const std::size_t composed_key_allocations =
+      mse_benchmark::CountAllocations([&]() { composed_key_hook.Process(no_op, context); });
+
+  std::cout << "cache hit with a 32 character key: generated key " << std::fixed << std::setprecision(2)
+            << measure(generated_key_hook) << "ns (" << generated_key_allocations << " allocations), composed key "
+            << measure(composed_key_hook) << "ns (" << composed_key_allocations << " allocations)" << std::endl;
+  CHECK(composed_key_allocations == 0);
+}
+
+TEST_CASE("Bounded cache hit ratio", "[benchmark][cache]")
+{
+  const std::size_t capacity = 500;
+  std::minstd_rand random(42);
+  const std::vector<std::pair<std::string, std::vector<std::string>>> traces = {
+      {"zipf 0.8", create_zipf_trace(200000, 20000, 0.8, random)},
+      {"zipf 1.0", create_zipf_trace(200000, 20000, 1.0, random)},
+      {"zipf 0.8 + scans", create_scan_trace(200000, 20000, 0.8, 2000, random)}};
+
+  std::cout << "hit ratio with a capacity of " << capacity << " elements" << std::endl;
+  std::cout << std::setw(20) << "trace" << std::setw(16) << "LRUCache" << std::setw(16) << "ClockCache"
+            << std::setw(16) << "WTinyLFUCache" << std::endl;
+  for (const auto& [name, trace] : traces)
+  {
+    mse::LRUCache lru_cache(std::make_shared<mse::UnorderedMapCache>(), capacity);
+    mse::ClockCache clock_cache(capacity, 1);
+    mse::WTinyLFUCache w_tiny_lfu_cache(std::make_shared<mse::UnorderedMapCache>(), capacity);
+
+    const double lru_hit_ratio = measure_hit_ratio(lru_cache, trace);
+    const double w_tiny_lfu_hit_ratio = measure_hit_ratio(w_tiny_lfu_cache, trace);
+    std::cout << std::setw(20) << name << std::fixed << std::setprecision(3) << std::setw(16) << lru_hit_ratio
+              << std::setw(16) << measure_hit_ratio(clock_cache, trace) << std::setw(16) << w_tiny_lfu_hit_ratio
+              << std::endl;
+    CHECK(w_tiny_lfu_hit_ratio > lru_hit_ratio);
+  }
+}
@@ -0,0 +1,104 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+#include <memory>
+#include <microservice-essentials/cross-cutting-concerns/exception-handling-request-hook.h>
+#include <microservice-essentials/observability/logger.h>
+#include <microservice-essentials/request/request-hook-factory.h>
+#include <microservice-essentials/request/request-processor.h>
+#include <microservice-essentials/request/static-pipeline.h>
+#include <utilities/allocation-counter.h>
+
+namespace
+{
+
+// cheap hook that only inspects the context, so that the measurement is dominated by the pipeline itself
+template <int Tag> class ContextCheckingRequestHook : public mse::RequestHook
+{
+public:
+  struct Parameters
+  {
+    mse::AutoRequestHookParameterRegistration<Parameters, ContextCheckingRequestHook> auto_registration;
+  };
+
+  ContextCheckingRequestHook(const Parameters&) : mse::RequestHook("context checking")
+  {
+  }
+
+protected:
+  virtual mse::Status pre_process(mse::Context& context) override
+  {
+    return context.Contains(mse::ContextKey::request) ? mse::Status::OK
+                                                      : mse::Status{mse::StatusCode::invalid_argument, ""};
+  }
+};
+
+typedef ContextCheckingRequestHook<1> HookA;
+typedef ContextCheckingRequestHook<2> HookB;
+
+mse::Status handle(mse::Context&)
+{
+  return mse::Status::OK;
+}
+
+} // namespace
+
+TEST_CASE("Static request pipeline with three hooks", "[benchmark][request]")
+{
+  mse::DiscardLogger logger;
+
+  mse::RequestProcessor processor("benchmark", mse::RequestType::incoming, mse::Context());
+  processor.With(std::make_unique<mse::ExceptionHandlingRequestHook>(mse::ExceptionHandlingRequestHook::Parameters()))
+      .With(std::make_unique<HookA>(HookA::Parameters()))
+      .With(std::make_unique<HookB>(HookB::Parameters()));
+
+  mse::StaticPipeline<mse::ExceptionHandlingRequestHook, HookA, HookB> pipeline(
+      "benchmark", mse::RequestType::incoming, mse::Context(), mse::ExceptionHandlingRequestHook::Parameters(),
+      HookA::Parameters(), HookB::Parameters());
+
+  const std::size_t dynamic_allocations = mse_benchmark::CountAllocations([&]() { processor.Process(handle); });
+  const std::size_t static_allocations = mse_benchmark::CountAllocations([&]() { pipeline.Process(handle); });
+  std::cout << "allocations per request: mse::RequestProcessor " << dynamic_allocations << ", mse::StaticPipeline "
+            << static_allocations << std::endl;
+  CHECK(static_allocations < dynamic_allocations);
+
+  BENCHMARK("mse::RequestProcessor")
+  {
+    return processor.Process(handle).code;
+  };
+
+  BENCHMARK("mse::StaticPipeline")
+  {
+    return pipeline.Process(handle).code;
+  };
+}
+
+TEST_CASE("Prebuilt request pipeline with global hooks", "[benchmark][request]")
+{
+  mse::DiscardLogger logger;
+
+  mse::RequestHandler::GloballyWith(mse::ExceptionHandlingRequestHook::Parameters());
+  mse::RequestHandler::GloballyWith(HookA::Parameters());
+  const mse::RequestPipeline pipeline = mse::RequestHandler::BuildPipeline("benchmark");
+
+  auto handle_with_request_handler = []() { return mse::RequestHandler("benchmark", mse::Context()).Process(handle); };
+  auto handle_with_pipeline = [&pipeline]() { return pipeline.Process(handle, mse::Context()); };
+
+  const std::size_t handler_allocations = mse_benchmark::CountAllocations(handle_with_request_handler);
+  const std::size_t pipeline_allocations = mse_benchmark::CountAllocations(handle_with_pipeline);
+  std::cout << "allocations per request: mse::RequestHandler " << handler_allocations << ", mse::RequestPipeline "
+            << pipeline_allocations << std::endl;
+  CHECK(pipeline_allocations < handler_allocations);
+
+  BENCHMARK("mse::RequestHandler")
+  {
+    return handle_with_request_handler().code;
+  };
+
+  BENCHMARK("mse::RequestPipeline")
+  {
+    return handle_with_pipeline().code;
+  };
+
+  mse::RequestHandler::ClearGlobalHooks();
+}
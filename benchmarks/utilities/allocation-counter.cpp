@@ -0,0 +1,58 @@
+#include "allocation-counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+std::atomic<std::size_t> allocation_count{0};
+
+void* counting_allocate(std::size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr)
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+} // namespace
+
+std::size_t mse_benchmark::CountAllocations(const std::function<void()>& func)
+{
+  const std::size_t count_before = allocation_count.load();
+  func();
+  return allocation_count.load() - count_before;
+}
+
+void* operator new(std::size_t size)
+{
+  return counting_allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return counting_allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace mse_benchmark
+{
+
+/**
+ * Counts the heap allocations (calls to the global operator new) that occur while executing func.
+ * The global operator new is replaced in allocation-counter.cpp for the benchmark executable.
+ */
+std::size_t CountAllocations(const std::function<void()>& func);
+
+} // namespace mse_benchmark
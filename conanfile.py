@@ -15,11 +15,13 @@ class MicroserviceEssentials(ConanFile):
     }
     options = {
         "build_testing": [True, False],
-        "build_examples": [True, False]        
+        "build_examples": [True, False],
+        "build_benchmarks": [True, False]
     }
     default_options = {
         "build_testing": False,
-        "build_examples": False
+        "build_examples": False,
+        "build_benchmarks": False
     }
 
     def requirements(self):
@@ -32,11 +34,14 @@ class MicroserviceEssentials(ConanFile):
         if self.options.build_testing:
             self.requires("catch2/3.4.0")
             self.requires("nlohmann_json/3.11.2")
+        if self.options.build_benchmarks and not self.options.build_testing:
+            self.requires("catch2/3.4.0")
 
     def build(self):
         cmake = CMake(self)
         cmake.definitions['BUILD_TESTING'] = self.options.build_testing
         cmake.definitions['BUILD_EXAMPLES'] = self.options.build_examples
+        cmake.definitions['BUILD_BENCHMARKS'] = self.options.build_benchmarks
         cmake.configure()
         cmake.build()
 
@@ -103,7 +103,7 @@ public:
             .With(mse::CachingRequestHook::Parameters(_cache)
                       .WithConstantResponse()
                       .WithCacheReader([response](const std::any& data) {
-                        response->ParseFromString(std::any_cast<std::string>(data));
+                        response->ParseFromString(std::any_cast<const std::string&>(data));
                       })
                       .WithCacheWriter([response]() -> std::any { return response->SerializeAsString(); })
                       .NeverExpire())
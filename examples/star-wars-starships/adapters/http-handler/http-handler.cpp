@@ -2,8 +2,12 @@
 #include <microservice-essentials/context.h>
 #include <microservice-essentials/observability/logger.h>
 #include <microservice-essentials/performance/caching-request-hook.h>
+#include <microservice-essentials/performance/tagged-cache.h>
+#include <microservice-essentials/performance/thread-local-cache.h>
+#include <microservice-essentials/performance/weighted-lru-cache.h>
 #include <microservice-essentials/request/request-processor.h>
 #include <microservice-essentials/security/claim-checker-request-hook.h>
+#include <microservice-essentials/utilities/executor.h>
 #include <microservice-essentials/utilities/metadata-converter.h>
 #include <microservice-essentials/utilities/status-converter.h>
 #define CPPHTTPLIB_OPENSSL_SUPPORT // be consistent with other projects to prevent seg fault
@@ -89,8 +93,18 @@ std::string extractId(const std::string& path)
 
 HttpHandler::HttpHandler(Api& api, const std::string& host, int port)
     : _api(api), _svr(std::make_unique<httplib::Server>()), _host(host), _port(port),
-      _cache(std::make_shared<mse::UnorderedMapCache>())
+      // the hot star ship list is served from a per-thread L1 cache
+      _cache(std::make_shared<mse::TaggedCache>(std::make_shared<mse::ThreadLocalCache>(
+          std::make_shared<mse::WeightedLRUCache>(std::make_shared<mse::UnorderedMapCache>(),
+                                                  16 * 1024 * 1024)))), // the default weigher counts bytes
+      _refresh_executor(std::make_shared<mse::ThreadPoolExecutor>(1)),
+      _get_star_ship_pipeline(mse::RequestHandler::BuildPipeline("getStarShip")),
+      _update_status_pipeline(mse::RequestHandler::BuildPipeline("updateStatus"))
 {
+  // the hooks of these endpoints do not depend on the individual request, so they are only created once
+  _get_star_ship_pipeline.With(mse::ClaimCheckerRequestHook::ScopeContains("read"));
+  _update_status_pipeline.With(mse::ClaimCheckerRequestHook::ScopeContains("write"));
+
   _svr->Get("/StarShips", std::bind(&HttpHandler::listStarShips, this, std::placeholders::_1, std::placeholders::_2));
   _svr->Get("/StarShip/(.*)", std::bind(&HttpHandler::getStarShip, this, std::placeholders::_1, std::placeholders::_2));
   _svr->Put("/StarShipStatus/(.*)", httplib::Server::Handler(std::bind(&HttpHandler::updateStatus, this,
@@ -122,10 +136,19 @@ void HttpHandler::listStarShips(const httplib::Request& request, httplib::Respon
                                 .With(mse::CachingRequestHook::Parameters(_cache)
                                           .WithConstantResponse()
                                           .WithCacheReader([&response](const std::any& data) {
-                                            response.set_content(std::any_cast<std::string>(data), "text/json");
+                                            response.set_content(std::any_cast<const std::string&>(data), "text/json");
                                           })
-                                          .WithCacheWriter([&content]() -> std::any { return content; })
-                                          .NeverExpire())
+                                          .WithCacheWriter([&content]() -> std::any { return std::move(content); })
+                                          .WithTags({"starships"})
+                                          .WithMaxAge(std::chrono::minutes(1))
+                                          .WithRefreshAhead(0.8)
+                                          .WithStaleWhileRevalidate(std::chrono::minutes(1))
+                                          .WithBackgroundRefresh(
+                                              [this](std::any& data) {
+                                                data = to_json(_api.ListStarShips()).dump();
+                                                return mse::Status::OK;
+                                              },
+                                              _refresh_executor))
                                 .Process([&](mse::Context&) {
                                   content = to_json(_api.ListStarShips()).dump();
                                   response.set_content(content, "text/json");
@@ -137,23 +160,26 @@ void HttpHandler::listStarShips(const httplib::Request& request, httplib::Respon
 void HttpHandler::getStarShip(const httplib::Request& request, httplib::Response& response)
 {
   response.status = mse::ToHttpStatusCode(
-      mse::RequestHandler("getStarShip", mse::Context(mse::ToContextMetadata(request.headers)))
-          .With(mse::ClaimCheckerRequestHook::ScopeContains("read"))
-          .Process([&](mse::Context&) {
-            response.set_content(to_json(_api.GetStarShip(extractId(request.path))).dump(), "text/json");
-            return mse::Status();
-          })
+      _get_star_ship_pipeline
+          .Process(
+              [&](mse::Context&) {
+                response.set_content(to_json(_api.GetStarShip(extractId(request.path))).dump(), "text/json");
+                return mse::Status();
+              },
+              mse::Context(mse::ToContextMetadata(request.headers)))
           .code);
 }
 
 void HttpHandler::updateStatus(const httplib::Request& request, httplib::Response& response)
 {
   response.status = mse::ToHttpStatusCode(
-      mse::RequestHandler("updateStatus", mse::Context(mse::ToContextMetadata(request.headers)))
-          .With(mse::ClaimCheckerRequestHook::ScopeContains("write"))
-          .Process([&](mse::Context&) {
-            _api.UpdateStatus(extractId(request.path), from_string(json::parse(request.body).at("status")));
-            return mse::Status();
-          })
+      _update_status_pipeline
+          .Process(
+              [&](mse::Context&) {
+                _api.UpdateStatus(extractId(request.path), from_string(json::parse(request.body).at("status")));
+                _cache->InvalidateTag("starships"); // the cached list contains the updated status
+                return mse::Status();
+              },
+              mse::Context(mse::ToContextMetadata(request.headers)))
           .code);
 }
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <microservice-essentials/handler.h>
+#include <microservice-essentials/request/request-pipeline.h>
 #include <microservice-essentials/utilities/environment.h>
 #include <ports/api.h>
 #include <string>
@@ -15,7 +16,8 @@ class Response;
 
 namespace mse
 {
-class Cache;
+class Executor;
+class TaggedCache;
 } //  namespace mse
 
 class HttpHandler : public mse::Handler
@@ -37,5 +39,8 @@ private:
   std::unique_ptr<httplib::Server> _svr;
   const std::string _host;
   const int _port;
-  std::shared_ptr<mse::Cache> _cache;
+  std::shared_ptr<mse::TaggedCache> _cache;
+  std::shared_ptr<mse::Executor> _refresh_executor;
+  mse::RequestPipeline _get_star_ship_pipeline;
+  mse::RequestPipeline _update_status_pipeline;
 };
@@ -65,8 +65,7 @@ std::vector<StarshipProperties> HttpStarWarsClient::ListStarShipProperties() con
       .Process([&](mse::Context& context) {
         for (std::string path = "/api/starships/?format=json"; path != "";)
         {
-          auto resp = _cli->Get(
-              path, mse::FromContextMetadata<httplib::Headers>(context.GetFilteredMetadata(_headers_to_propagate)));
+          auto resp = _cli->Get(path, mse::FromContextMetadata<httplib::Headers>(context, _headers_to_propagate));
           if (!resp)
           {
             return mse::Status{mse::StatusCode::unknown, ""};
@@ -101,15 +100,16 @@ std::optional<StarshipProperties> HttpStarWarsClient::GetStarShipProperties(cons
                 .WithKey(starshipId)
                 .WithCachedObject(starshipProperties)
                 .NeverExpire()
-                .Include(mse::StatusCode::not_found))
+                .WithMaxAge(mse::StatusCode::not_found, 10min)
+                .WithMaxAge(mse::StatusCode::unavailable, 5s) // sheds load while swapi is down
+                .WithRequestCoalescing())
       .With(mse::RetryRequestHook::Parameters(std::make_shared<mse::BackoffGaussianJitterDecorator>(
           std::make_shared<mse::LinearRetryBackoff>(3, 10000ms), 1000ms)))
-      .Process([&](mse::Context&) {
+      .Process([&](mse::Context& context) {
         mse::Status status{mse::StatusCode::unknown, ""};
-        mse::Context client_context = mse::Context::GetThreadLocalContext();
-        if (auto resp = _cli->Get(
-                std::string("/api/starships/") + starshipId + "/?format=json",
-                mse::FromContextMetadata<httplib::Headers>(client_context.GetFilteredMetadata(_headers_to_propagate)));
+        // the request context's ancestors include the thread local context, i.e. there is no need to copy it
+        if (auto resp = _cli->Get(std::string("/api/starships/") + starshipId + "/?format=json",
+                                  mse::FromContextMetadata<httplib::Headers>(context, _headers_to_propagate));
             resp)
         {
           status.code = mse::FromHttpStatusCode(resp->status);
@@ -0,0 +1,142 @@
+#include "context-key.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
+using namespace mse;
+
+namespace
+{
+
+class KeyRegistry
+{
+public:
+  static KeyRegistry& GetInstance()
+  {
+    static KeyRegistry instance;
+    return instance;
+  }
+
+  ContextKey::Id Intern(std::string_view key)
+  {
+    // lock-free for indexed keys, so that hooks that are constructed per request do not contend on the mutex
+    if (const ContextKey::Id id = FindIndexed(key); id != ContextKey::invalid_id)
+    {
+      return id;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (const ContextKey::Id id = FindIndexed(key); id != ContextKey::invalid_id)
+    {
+      return id; // interned by another thread in the meantime
+    }
+    for (std::size_t i = 0; i < _other_keys.size(); ++i)
+    {
+      if (_other_keys[i] == key)
+      {
+        return static_cast<ContextKey::Id>(ContextKey::max_indexed_keys + i);
+      }
+    }
+
+    const std::size_t indexed_key_count = _indexed_key_count.load(std::memory_order_relaxed);
+    if (indexed_key_count < ContextKey::max_indexed_keys)
+    {
+      _indexed_keys[indexed_key_count] = std::string(key);
+      const std::size_t hash = std::hash<std::string_view>()(key);
+      _indexed_hashes[indexed_key_count] = hash;
+      std::size_t slot = hash % _hash_table.size();
+      while (_hash_table[slot].load(std::memory_order_relaxed) != ContextKey::invalid_id)
+      {
+        slot = (slot + 1) % _hash_table.size();
+      }
+      _hash_table[slot].store(static_cast<ContextKey::Id>(indexed_key_count), std::memory_order_release);
+      _indexed_key_count.store(indexed_key_count + 1, std::memory_order_release); // publish after the key is written
+      return static_cast<ContextKey::Id>(indexed_key_count);
+    }
+    if (ContextKey::max_indexed_keys + _other_keys.size() >= ContextKey::invalid_id)
+    {
+      throw std::length_error("too many context keys");
+    }
+    _other_keys.emplace_back(key);
+    return static_cast<ContextKey::Id>(ContextKey::max_indexed_keys + _other_keys.size() - 1);
+  }
+
+  ContextKey::Id FindIndexed(std::string_view key) const
+  {
+    // one hash and usually one string comparison instead of comparing all indexed keys
+    const std::size_t hash = std::hash<std::string_view>()(key);
+    for (std::size_t slot = hash % _hash_table.size();; slot = (slot + 1) % _hash_table.size())
+    {
+      const ContextKey::Id id = _hash_table[slot].load(std::memory_order_acquire);
+      if (id == ContextKey::invalid_id)
+      {
+        return ContextKey::invalid_id; // the table is never more than half full, i.e. there is always a free slot
+      }
+      if (_indexed_hashes[id] == hash && _indexed_keys[id] == key)
+      {
+        return id;
+      }
+    }
+  }
+
+  std::size_t GetIndexedKeyCount() const
+  {
+    return _indexed_key_count.load(std::memory_order_acquire);
+  }
+
+  const std::string& At(ContextKey::Id id)
+  {
+    if (id < ContextKey::max_indexed_keys)
+    {
+      return _indexed_keys[id]; // never changes once it has been published
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _other_keys.at(id - ContextKey::max_indexed_keys); // references into a deque remain valid on emplace_back
+  }
+
+private:
+  KeyRegistry()
+  {
+    for (std::atomic<ContextKey::Id>& slot : _hash_table)
+    {
+      slot.store(ContextKey::invalid_id, std::memory_order_relaxed);
+    }
+    // must match the order of ContextKey::WellKnown
+    for (const char* key : {"request", "app", "x-b3-traceid", "x-b3-spanid", "scope", "authorization", "file",
+                            "function", "line", "timestamp"})
+    {
+      Intern(key);
+    }
+  }
+
+  std::mutex _mutex;
+  std::array<std::string, ContextKey::max_indexed_keys> _indexed_keys;
+  std::array<std::size_t, ContextKey::max_indexed_keys> _indexed_hashes;
+  // open addressing from the hash of a key to its id. Slots are published after the key has been written.
+  std::array<std::atomic<ContextKey::Id>, 2 * ContextKey::max_indexed_keys> _hash_table;
+  std::atomic<std::size_t> _indexed_key_count{0};
+  std::deque<std::string> _other_keys;
+};
+
+} // namespace
+
+ContextKey::ContextKey(std::string_view key) : _id(KeyRegistry::GetInstance().Intern(key))
+{
+}
+
+const std::string& ContextKey::str() const
+{
+  return KeyRegistry::GetInstance().At(_id);
+}
+
+ContextKey::Id ContextKey::FindIndexed(std::string_view key)
+{
+  return KeyRegistry::GetInstance().FindIndexed(key);
+}
+
+std::size_t ContextKey::GetIndexedKeyCount()
+{
+  return KeyRegistry::GetInstance().GetIndexedKeyCount();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mse
+{
+
+/**
+ * Handle of an interned context metadata key.
+ *
+ * Keys are interned in a global registry. The well-known keys that are used throughout the library (e.g.
+ * ContextKey::request or ContextKey::trace_id) are interned from the start. Additional keys can be interned by
+ * constructing a ContextKey once (e.g. as a member of a request hook) and reusing it. Context::Metadata keeps track of
+ * the position of the first max_indexed_keys interned keys so that Context::At/AtOr/Contains can look up such a key by
+ * its handle in O(1) without hashing, comparing, or allocating strings. Keys that are interned beyond that limit still
+ * work, but are looked up by string. Constructing a ContextKey for an indexed key that has been interned already does
+ * not lock, so hooks that are constructed per request may construct their keys as well.
+ */
+class ContextKey
+{
+public:
+  typedef std::uint16_t Id;
+  static constexpr std::size_t max_indexed_keys = 32;
+  static constexpr Id invalid_id = 0xffff;
+
+  enum class WellKnown : Id
+  {
+    request,
+    app,
+    trace_id,
+    span_id,
+    scope,
+    authorization,
+    file,
+    function,
+    line,
+    timestamp
+  };
+
+  constexpr ContextKey(WellKnown well_known_key) : _id(static_cast<Id>(well_known_key))
+  {
+  }
+  explicit ContextKey(std::string_view key);
+
+  Id GetId() const
+  {
+    return _id;
+  }
+  bool IsIndexed() const
+  {
+    return _id < max_indexed_keys;
+  }
+  const std::string& str() const;
+
+  // returns the id of an already interned key that is indexed by Context::Metadata or invalid_id. Does not lock.
+  static Id FindIndexed(std::string_view key);
+  // number of interned keys that are indexed by Context::Metadata
+  static std::size_t GetIndexedKeyCount();
+
+  static const ContextKey request;       // "request"
+  static const ContextKey app;           // "app"
+  static const ContextKey trace_id;      // "x-b3-traceid"
+  static const ContextKey span_id;       // "x-b3-spanid"
+  static const ContextKey scope;         // "scope"
+  static const ContextKey authorization; // "authorization"
+  static const ContextKey file;          // "file"
+  static const ContextKey function;      // "function"
+  static const ContextKey line;          // "line"
+  static const ContextKey timestamp;     // "timestamp"
+
+private:
+  Id _id;
+};
+
+inline constexpr ContextKey ContextKey::request{ContextKey::WellKnown::request};
+inline constexpr ContextKey ContextKey::app{ContextKey::WellKnown::app};
+inline constexpr ContextKey ContextKey::trace_id{ContextKey::WellKnown::trace_id};
+inline constexpr ContextKey ContextKey::span_id{ContextKey::WellKnown::span_id};
+inline constexpr ContextKey ContextKey::scope{ContextKey::WellKnown::scope};
+inline constexpr ContextKey ContextKey::authorization{ContextKey::WellKnown::authorization};
+inline constexpr ContextKey ContextKey::file{ContextKey::WellKnown::file};
+inline constexpr ContextKey ContextKey::function{ContextKey::WellKnown::function};
+inline constexpr ContextKey ContextKey::line{ContextKey::WellKnown::line};
+inline constexpr ContextKey ContextKey::timestamp{ContextKey::WellKnown::timestamp};
+
+} // namespace mse
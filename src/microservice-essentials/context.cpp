@@ -10,6 +10,9 @@ using namespace mse;
 namespace
 {
 
+// thread local context that has been installed by a Context::ThreadLocalScope
+thread_local Context* scoped_thread_local_context = nullptr;
+
 std::string to_string(std::chrono::time_point<std::chrono::system_clock> tp)
 {
   std::time_t tt = std::chrono::system_clock::to_time_t(tp);
@@ -24,6 +27,32 @@ std::string to_string(std::chrono::time_point<std::chrono::system_clock> tp)
   return ss.str();
 }
 
+enum SourceLocationKey : std::uint8_t
+{
+  file_key = 0x01,
+  function_key = 0x02,
+  line_key = 0x04,
+  timestamp_key = 0x08
+};
+
+std::uint8_t source_location_keys(std::string_view key)
+{
+  return key == "file"        ? file_key
+         : key == "function"  ? function_key
+         : key == "line"      ? line_key
+         : key == "timestamp" ? timestamp_key
+                              : 0;
+}
+
+std::uint8_t source_location_keys(const ContextKey& key)
+{
+  return key.GetId() == ContextKey::file.GetId()        ? file_key
+         : key.GetId() == ContextKey::function.GetId()  ? function_key
+         : key.GetId() == ContextKey::line.GetId()      ? line_key
+         : key.GetId() == ContextKey::timestamp.GetId() ? timestamp_key
+                                                        : 0;
+}
+
 } // namespace
 
 Context::Context(const NoParent&) : _parent_context(nullptr)
@@ -38,6 +67,10 @@ Context::Context(const Metadata& metadata) : Context(metadata, nullptr)
 {
 }
 
+Context::Context(Metadata&& metadata) : Context(std::move(metadata), nullptr)
+{
+}
+
 Context::Context(std::initializer_list<Metadata::value_type> metadata, const Context* parent_context)
     : Context(Metadata(metadata), parent_context)
 {
@@ -59,11 +92,40 @@ Context::Context(const Metadata& metadata, const Context* parent_context)
   }
 }
 
-Context::Context(const Context* parent_context, const std::string& file, const std::string& function, int line,
+Context::Context(Metadata&& metadata, const Context* parent_context)
+    : _metadata(std::move(metadata)),
+      _parent_context(parent_context ? parent_context
+                                     : &GetThreadLocalContext() // let the thread local context be the parent
+      )
+{
+  if (parent_context == this) // I cannot be my own parent
+  {
+    throw std::logic_error("parent context is identical to its child");
+  }
+}
+
+Context::Context(const Metadata& metadata, const ContextSnapshot& parent_snapshot)
+    : Context(metadata, parent_snapshot._context.get())
+{
+  _shared_parent_context = parent_snapshot._context;
+}
+
+Context::Context(std::initializer_list<Metadata::value_type> metadata, const ContextSnapshot& parent_snapshot)
+    : Context(Metadata(metadata), parent_snapshot)
+{
+}
+
+Context::Context(const ContextSnapshot& parent_snapshot) : Context(Metadata(), parent_snapshot)
+{
+}
+
+Context::Context(const Context* parent_context, const char* file, const char* function, int line,
                  std::chrono::time_point<std::chrono::system_clock> tp)
-    : Context({{"file", file}, {"function", function}, {"line", std::to_string(line)}, {"timestamp", to_string(tp)}},
-              parent_context)
+    : Context(parent_context)
 {
+  // formatting is deferred until the metadata is accessed
+  _source_location = SourceLocation{file, function, line, tp};
+  _unformatted_source_location_keys = all_source_location_keys;
 }
 
 Context::Context() : Context({}, nullptr)
@@ -92,6 +154,8 @@ Context& Context::operator=(const Context& other_context)
   }
 
   _metadata = other_context._metadata;
+  _source_location = other_context._source_location;
+  _unformatted_source_location_keys = other_context._unformatted_source_location_keys;
   initParentContext(other_context);
   return *this;
 }
@@ -104,6 +168,8 @@ Context& Context::operator=(Context&& other_context)
   }
 
   _metadata = std::move(other_context._metadata);
+  _source_location = other_context._source_location;
+  _unformatted_source_location_keys = other_context._unformatted_source_location_keys;
   initParentContext(other_context);
   return *this;
 }
@@ -116,94 +182,196 @@ Context& Context::GetGlobalContext()
 
 Context& Context::GetThreadLocalContext()
 {
+  if (scoped_thread_local_context != nullptr)
+  {
+    return *scoped_thread_local_context;
+  }
   static thread_local Context threadlocal_context(
       &GetGlobalContext()); // global context is the parent of the thread local context
   return threadlocal_context;
 }
 
+Context::ThreadLocalScope::ThreadLocalScope(Context& context) : _previous_context(scoped_thread_local_context)
+{
+  scoped_thread_local_context = &context;
+}
+
+Context::ThreadLocalScope::~ThreadLocalScope()
+{
+  scoped_thread_local_context = _previous_context;
+}
+
 void Context::Clear()
 {
   _metadata.clear();
+  _unformatted_source_location_keys = 0;
 }
 
-size_t Context::Erase(const std::string& key)
+size_t Context::Erase(std::string_view key)
 {
+  formatSourceLocation(all_source_location_keys);
   return _metadata.erase(key);
 }
 
 Context::Metadata Context::GetAllMetadata() const
 {
-  Context::Metadata metadata = _metadata;
-  if (_parent_context != nullptr)
+  // entries of a child are inserted before the entries of its parents with the same key
+  Context::Metadata metadata = GetMetadata();
+  for (const Context* parent = _parent_context; parent != nullptr; parent = parent->_parent_context)
   {
-    metadata.merge(_parent_context->GetAllMetadata());
+    const Metadata& parent_metadata = parent->GetMetadata();
+    metadata.insert(parent_metadata.begin(), parent_metadata.end());
   }
   return metadata;
 }
 
 Context::Metadata Context::GetFilteredMetadata(const std::vector<std::string>& keys) const
 {
-  const Metadata all_metadata = GetAllMetadata();
   Metadata filtered_metadata;
-  for (const auto& key : keys)
+  VisitFilteredMetadata(keys,
+                        [&](const std::string& key, const std::string& value) { filtered_metadata.emplace(key, value); });
+  return filtered_metadata;
+}
+
+void Context::VisitAllMetadata(const MetadataVisitor& visitor) const
+{
+  for (const Context* context = this; context != nullptr; context = context->_parent_context)
   {
-    if (auto cit = all_metadata.find(key); cit != all_metadata.end())
+    for (const auto& key_value_pair : context->GetMetadata())
     {
-      filtered_metadata.insert(*cit);
+      if (!isShadowed(key_value_pair.first, context))
+      {
+        visitor(key_value_pair.first, key_value_pair.second);
+      }
     }
   }
-  return filtered_metadata;
 }
 
 void Context::Insert(const std::string& key, const std::string& value)
 {
-  _metadata.insert({key, value});
+  GetMetadata().insert({key, value});
+}
+
+void Context::Insert(const ContextKey& key, const std::string& value)
+{
+  GetMetadata().emplace(key, value);
 }
 
 void Context::Insert(std::initializer_list<Metadata::value_type> metadata)
 {
-  _metadata.insert(metadata);
+  GetMetadata().insert(metadata);
 }
 
-const std::string& Context::At(const std::string& key) const
+const std::string& Context::At(std::string_view key) const
 {
-  if (auto cit = _metadata.find(key); cit != _metadata.cend())
+  if (const Metadata::value_type* key_value_pair = find(key); key_value_pair != nullptr)
   {
-    return cit->second;
+    return key_value_pair->second;
   }
-  if (_parent_context != nullptr)
+  throw std::out_of_range(std::string(key) + " not found in context metadata");
+}
+
+const std::string& Context::At(const ContextKey& key) const
+{
+  if (const Metadata::value_type* key_value_pair = find(key); key_value_pair != nullptr)
   {
-    return _parent_context->At(key);
+    return key_value_pair->second;
   }
-  throw std::out_of_range(key + " not found in context metadata");
+  throw std::out_of_range(key.str() + " not found in context metadata");
 }
 
-const std::string& Context::AtOr(const std::string& key, const std::string& default_value) const
+const std::string& Context::AtOr(std::string_view key, const std::string& default_value) const
 {
-  if (auto cit = _metadata.find(key); cit != _metadata.cend())
+  if (const Metadata::value_type* key_value_pair = find(key); key_value_pair != nullptr)
   {
-    return cit->second;
+    return key_value_pair->second;
   }
-  if (_parent_context != nullptr)
+  return default_value;
+}
+
+const std::string& Context::AtOr(const ContextKey& key, const std::string& default_value) const
+{
+  if (const Metadata::value_type* key_value_pair = find(key); key_value_pair != nullptr)
   {
-    return _parent_context->AtOr(key, default_value);
+    return key_value_pair->second;
   }
   return default_value;
 }
 
-bool Context::Contains(const std::string& key) const
+bool Context::Contains(std::string_view key) const
+{
+  return find(key) != nullptr;
+}
+
+bool Context::Contains(const ContextKey& key) const
+{
+  return find(key) != nullptr;
+}
+
+template <typename Key> const Context::Metadata::value_type* Context::findInChain(const Key& key) const
 {
-  if (_metadata.find(key) != _metadata.cend())
+  const std::uint8_t keys_to_format = source_location_keys(key);
+  for (const Context* context = this; context != nullptr; context = context->_parent_context)
   {
-    return true;
+    context->formatSourceLocation(keys_to_format);
+    if (auto cit = context->_metadata.find(key); cit != context->_metadata.cend())
+    {
+      return &(*cit);
+    }
   }
-  if (_parent_context != nullptr)
+  return nullptr;
+}
+
+const Context::Metadata::value_type* Context::find(std::string_view key) const
+{
+  return findInChain(key);
+}
+
+const Context::Metadata::value_type* Context::find(const ContextKey& key) const
+{
+  return findInChain(key);
+}
+
+bool Context::isShadowed(std::string_view key, const Context* ancestor) const
+{
+  // a key of an ancestor is shadowed if any context between this instance and the ancestor contains that key as well
+  for (const Context* context = this; context != ancestor; context = context->_parent_context)
   {
-    return _parent_context->Contains(key);
+    if (context->_metadata.find(key) != context->_metadata.cend())
+    {
+      return true;
+    }
   }
   return false;
 }
 
+void Context::formatSourceLocation(std::uint8_t keys) const
+{
+  const std::uint8_t keys_to_format = keys & _unformatted_source_location_keys;
+  if (keys_to_format == 0)
+  {
+    return;
+  }
+  _unformatted_source_location_keys &= ~keys_to_format;
+
+  if (keys_to_format & file_key)
+  {
+    _metadata.emplace(ContextKey::file, _source_location.file);
+  }
+  if (keys_to_format & function_key)
+  {
+    _metadata.emplace(ContextKey::function, _source_location.function);
+  }
+  if (keys_to_format & line_key)
+  {
+    _metadata.emplace(ContextKey::line, std::to_string(_source_location.line));
+  }
+  if (keys_to_format & timestamp_key)
+  {
+    _metadata.emplace(ContextKey::timestamp, to_string(_source_location.timestamp));
+  }
+}
+
 std::set<const Context*> Context::getAllParents() const
 {
   std::set<const Context*> parents;
@@ -230,6 +398,26 @@ void Context::initParentContext(const Context& other_context)
         throw std::logic_error("I cannot be one of my ancestors");
       }
       _parent_context = other_context._parent_context;
+      _shared_parent_context = other_context._shared_parent_context;
+    }
+  }
+}
+
+ContextSnapshot::ContextSnapshot(const Context& context)
+{
+  // flatten the metadata of the whole chain, but keep referring to the global context
+  const Context* global_context = &Context::GetGlobalContext();
+  Context::Metadata metadata;
+  for (const Context* ancestor = &context; ancestor != nullptr && ancestor != global_context;
+       ancestor = ancestor->_parent_context)
+  {
+    for (const auto& key_value_pair : ancestor->GetMetadata())
+    {
+      if (!context.isShadowed(key_value_pair.first, ancestor))
+      {
+        metadata.insert(key_value_pair);
+      }
     }
   }
+  _context = std::make_shared<const Context>(std::move(metadata), global_context);
 }
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
-#include <map>
+#include <microservice-essentials/context-key.h>
+#include <memory>
+#include <microservice-essentials/flat-metadata.h>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #define MSE_LOCAL_CONTEXT mse::Context(nullptr, __FILE__, __FUNCTION__, __LINE__)
@@ -12,6 +17,8 @@
 namespace mse
 {
 
+class ContextSnapshot;
+
 /**
  * Class that typically holds request specific metadata (string->string) to be used throughout the request.
  *
@@ -21,27 +28,48 @@ namespace mse
  * A thread local context instance is accessible via the static method GetThreadLocalContext(). It holds metadata that
  * is valid for the whole thread. As each request is typically handled in a dedicated thread, this instance can be used
  * from anywhere without explicitly passing the context around. See the usage in the example's handler and client
- * classes.
+ * classes. A ThreadLocalScope temporarily replaces the thread local context by another instance (e.g. the context of
+ * the request that is currently handled) without copying it.
  *
  * Each context has a parent that can be specified during construction. If no parent is specified (i.e. nullptr) the
- * thread local context is used as the parent. The thread local context's parent is the global context by default. Use
+ * thread local context is used as the parent, i.e. the context that is installed by a ThreadLocalScope if any (see
+ * there for the lifetime implications). The thread local context's parent is the global context by default. Use
  * GetAllMetaData() to get the combined metadata of the the instance, its parent, its parent's parent, and so on. The
  * Insert()- and Contains()- method operates on GetAllMetaData()
  *
+ * All lookups take a std::string_view, i.e. probing for a key never allocates.
+ *
+ * VisitAllMetadata() and VisitFilteredMetadata() walk along the chain of parents without copying any metadata. A key
+ * that is present in a context shadows the entries with the same key of all its ancestors. Prefer them over
+ * GetAllMetadata() and GetFilteredMetadata() in hot paths such as logging or header propagation.
+ *
+ * The metadata is stored in a FlatMetadata instance, which provides a std::multimap like interface without allocating
+ * for typical request sizes. Frequently used keys should be accessed via a ContextKey handle, which is looked up in O(1).
+ *
+ * A local context (see MSE_LOCAL_CONTEXT) stores the source location and the timestamp in raw form. They are formatted
+ * to the "file", "function", "line", and "timestamp" metadata only when they are accessed for the first time. As this
+ * happens lazily even on const access, a local context must not be read concurrently by multiple threads.
+ *
  * Utilities/metadata-converter can be used to convert from and to technology specific context equivalent objects.
  */
 class Context
 {
 public:
-  typedef std::multimap<std::string, std::string> Metadata;
+  typedef FlatMetadata Metadata;
   typedef std::vector<Metadata::value_type> MetadataVector;
+  typedef std::function<void(const std::string& key, const std::string& value)> MetadataVisitor;
 
   Context(const Metadata& metadata, const Context* parent_context);
+  Context(Metadata&& metadata, const Context* parent_context);
   Context(const Context* parent_context);
   Context(const Metadata& metadata);
+  Context(Metadata&& metadata);
   Context(std::initializer_list<Metadata::value_type> metadata, const Context* parent_context);
   Context(std::initializer_list<Metadata::value_type> metadata);
-  Context(const Context* parent_context, const std::string& file, const std::string& function, int line,
+  Context(const Metadata& metadata, const ContextSnapshot& parent_snapshot);
+  Context(std::initializer_list<Metadata::value_type> metadata, const ContextSnapshot& parent_snapshot);
+  Context(const ContextSnapshot& parent_snapshot);
+  Context(const Context* parent_context, const char* file, const char* function, int line,
           std::chrono::time_point<std::chrono::system_clock> tp = std::chrono::system_clock::now());
   Context();
   Context(const Context& other_context);
@@ -54,37 +82,123 @@ public:
   static Context& GetGlobalContext();
   static Context& GetThreadLocalContext();
 
+  /**
+   * RAII guard that makes the given context the thread local context of the current thread for its lifetime and
+   * restores the previous thread local context on destruction. The context is neither copied nor moved, i.e. it must
+   * outlive the guard. Contexts that are constructed without parent within the scope refer to the given context, i.e.
+   * they must not outlive it either. A context that outlives the scope (e.g. one that is captured by an asynchronous
+   * task or stored in a member) must be constructed with a ContextSnapshot of the thread local context as parent.
+   */
+  class ThreadLocalScope
+  {
+  public:
+    ThreadLocalScope(Context& context);
+    ~ThreadLocalScope();
+
+    ThreadLocalScope(const ThreadLocalScope&) = delete;
+    ThreadLocalScope& operator=(const ThreadLocalScope&) = delete;
+
+  private:
+    Context* _previous_context;
+  };
+
   void Clear();
-  size_t Erase(const std::string& key);
+  size_t Erase(std::string_view key);
 
   const Metadata& GetMetadata() const
   {
+    formatSourceLocation(all_source_location_keys);
     return _metadata;
   }
   Metadata& GetMetadata()
   {
+    formatSourceLocation(all_source_location_keys);
     return _metadata;
   }
   Metadata GetAllMetadata() const;
   Metadata GetFilteredMetadata(const std::vector<std::string>& keys) const;
+  void VisitAllMetadata(const MetadataVisitor& visitor) const;
+  template <typename Keys = std::vector<std::string>>
+  void VisitFilteredMetadata(const Keys& keys, const MetadataVisitor& visitor) const;
 
   void Insert(std::initializer_list<Metadata::value_type> metadata);
   void Insert(const std::string& key, const std::string& value);
-  const std::string& At(const std::string& key) const;
-  const std::string& AtOr(const std::string& key, const std::string& default_value) const;
-  bool Contains(const std::string& key) const;
+  void Insert(const ContextKey& key, const std::string& value);
+  const std::string& At(std::string_view key) const;
+  const std::string& At(const ContextKey& key) const;
+  const std::string& AtOr(std::string_view key, const std::string& default_value) const;
+  const std::string& AtOr(const ContextKey& key, const std::string& default_value) const;
+  bool Contains(std::string_view key) const;
+  bool Contains(const ContextKey& key) const;
 
 private:
+  friend class ContextSnapshot;
+
   class NoParent
   {
   };
+
+  struct SourceLocation
+  {
+    const char* file = nullptr;
+    const char* function = nullptr;
+    int line = 0;
+    std::chrono::time_point<std::chrono::system_clock> timestamp;
+  };
+  static constexpr std::uint8_t all_source_location_keys = 0x0f;
+
   Context(const NoParent& no_parent);
 
   void initParentContext(const Context& other_context);
+  const Metadata::value_type* find(std::string_view key) const;
+  const Metadata::value_type* find(const ContextKey& key) const;
+  template <typename Key> const Metadata::value_type* findInChain(const Key& key) const;
+  bool isShadowed(std::string_view key, const Context* ancestor) const;
   std::set<const Context*> getAllParents() const;
+  void formatSourceLocation(std::uint8_t keys) const;
 
-  Metadata _metadata;
+  mutable Metadata _metadata; // mutable, because the source location is formatted lazily
   const Context* _parent_context = nullptr;
+  std::shared_ptr<const Context> _shared_parent_context; // keeps a snapshot alive that is the parent of this instance
+  SourceLocation _source_location;
+  mutable std::uint8_t _unformatted_source_location_keys = 0; // bit mask of the keys that are not in _metadata yet
+};
+
+/**
+ * Immutable, reference counted snapshot of a context's metadata including the metadata of all its ancestors (except for
+ * the global context, which remains the parent of the snapshot).
+ *
+ * Creating a snapshot copies the metadata once. Afterwards, the snapshot can be copied in O(1) and shared by multiple
+ * threads and outgoing requests (e.g. when an incoming request fans out to several RequestIssuers that run in
+ * parallel). A Context that is constructed with a snapshot as parent is a cheap overlay on top of the shared metadata
+ * and keeps the snapshot alive.
+ *
+ * Code snippet:
+ * mse::ContextSnapshot snapshot(mse::Context::GetThreadLocalContext());
+ * auto future = std::async([snapshot]() {
+ *   return mse::RequestIssuer("myRequest", mse::Context(snapshot)).Process(...);
+ * });
+ */
+class ContextSnapshot
+{
+public:
+  explicit ContextSnapshot(const Context& context);
+
+  const Context& GetContext() const
+  {
+    return *_context;
+  }
+  const Context* operator->() const
+  {
+    return _context.get();
+  }
+
+private:
+  friend class Context;
+
+  std::shared_ptr<const Context> _context;
 };
 
 } // namespace mse
+
+#include "context.txx"
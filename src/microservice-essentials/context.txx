@@ -0,0 +1,19 @@
+#pragma once
+
+#include "context.h"
+
+namespace mse
+{
+
+template <typename Keys> void Context::VisitFilteredMetadata(const Keys& keys, const MetadataVisitor& visitor) const
+{
+  for (const auto& key : keys)
+  {
+    if (const Metadata::value_type* key_value_pair = find(std::string_view(key)); key_value_pair != nullptr)
+    {
+      visitor(key_value_pair->first, key_value_pair->second);
+    }
+  }
+}
+
+} // namespace mse
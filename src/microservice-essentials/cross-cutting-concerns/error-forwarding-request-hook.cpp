@@ -74,7 +74,7 @@ Status ErrorForwardingRequestHook::post_process(Context& context, Status status)
   if (cit != _parameters.status_code_mapping.end())
   {
     std::stringstream details_stream;
-    details_stream << context.AtOr("request", "") << " received " << to_string(status.code);
+    details_stream << context.AtOr(ContextKey::request, "") << " received " << to_string(status.code);
     if (!status.details.empty())
     {
       details_stream << "(" << status.details << ")";
@@ -1,4 +1,6 @@
 #include "exception-handling-request-hook.h"
+#include <atomic>
+#include <memory>
 #include <microservice-essentials/cross-cutting-concerns/error-forwarding-request-hook.h>
 
 namespace
@@ -61,48 +63,74 @@ Status ExceptionHandlingRequestHook::Process(Func func, Context& context)
   }
   catch (...)
   {
-    // check all exception types that shall be handled
-    for (std::shared_ptr<ExceptionHandling::Mapper> exception_handling_mapper : _parameters.exception_handling_mappers)
+    return handleCurrentException();
+  }
+}
+
+void ExceptionHandlingRequestHook::ProcessAsync(AsyncFunc func, Context& context, Continuation continuation)
+{
+  // exceptions that are thrown after the function has continued are not related to this request's processing
+  std::shared_ptr<std::atomic<bool>> continued = std::make_shared<std::atomic<bool>>(false);
+  try
+  {
+    func(context, [continuation, continued](Status status) {
+      *continued = true;
+      continuation(status);
+    });
+  }
+  catch (...)
+  {
+    if (*continued)
     {
-      std::optional<mse::ExceptionHandling::Definition> definition =
-          exception_handling_mapper->Map(std::current_exception());
-      if (definition.has_value())
-      {
+      throw;
+    }
+    continuation(handleCurrentException());
+  }
+}
 
-        if (definition->log_level == mse::LogLevel::invalid && !definition->forward_exception_details_to_caller)
-        {
-          // exception details are not required => early exit
-          return definition->status;
-        }
+Status ExceptionHandlingRequestHook::handleCurrentException() const
+{
+  // check all exception types that shall be handled
+  for (std::shared_ptr<ExceptionHandling::Mapper> exception_handling_mapper : _parameters.exception_handling_mappers)
+  {
+    std::optional<mse::ExceptionHandling::Definition> definition =
+        exception_handling_mapper->Map(std::current_exception());
+    if (definition.has_value())
+    {
 
-        std::string exception_details = extract_exception_details(std::current_exception());
+      if (definition->log_level == mse::LogLevel::invalid && !definition->forward_exception_details_to_caller)
+      {
+        // exception details are not required => early exit
+        return definition->status;
+      }
 
-        if (definition->log_level != mse::LogLevel::invalid)
-        {
-          mse::LogProvider::GetInstance().GetLogger().Write(definition->log_level,
-                                                            std::string("caught exception: ") + exception_details);
-        }
+      std::string exception_details = extract_exception_details(std::current_exception());
+
+      if (definition->log_level != mse::LogLevel::invalid)
+      {
+        mse::LogProvider::GetInstance().GetLogger().Write(definition->log_level,
+                                                          std::string("caught exception: ") + exception_details);
+      }
 
-        if (definition->forward_exception_details_to_caller)
+      if (definition->forward_exception_details_to_caller)
+      {
+        mse::Status status = definition->status;
+        if (status.details.empty())
         {
-          mse::Status status = definition->status;
-          if (status.details.empty())
-          {
-            status.details = exception_details;
-          }
-          else
-          {
-            status.details += std::string(": ") + exception_details;
-          }
-          return status;
+          status.details = exception_details;
         }
         else
         {
-          return definition->status;
+          status.details += std::string(": ") + exception_details;
         }
+        return status;
+      }
+      else
+      {
+        return definition->status;
       }
     }
-    // rethrow
-    throw;
   }
+  // rethrow
+  throw;
 }
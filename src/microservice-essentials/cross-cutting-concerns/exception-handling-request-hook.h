@@ -18,6 +18,7 @@ namespace mse
  * Note that exception details are only available for exceptions derived from std::exception.
  * The order of exception handling definitions defines the handling priority.
  * Any exception not matched by any of the exception handling definitions will be rethrown.
+ * For asynchronously processed requests, only exceptions that are thrown before the request is continued are handled.
  */
 class ExceptionHandlingRequestHook : public mse::RequestHook
 {
@@ -36,8 +37,11 @@ public:
   virtual ~ExceptionHandlingRequestHook();
 
   virtual Status Process(Func func, Context& context) override;
+  virtual void ProcessAsync(AsyncFunc func, Context& context, Continuation continuation) override;
 
 private:
+  Status handleCurrentException() const;
+
   Parameters _parameters;
   static const std::vector<std::shared_ptr<ExceptionHandling::Mapper>> _default_exception_handling_mappers;
 };
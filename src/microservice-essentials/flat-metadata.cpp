@@ -0,0 +1,247 @@
+#include "flat-metadata.h"
+#include <algorithm>
+
+using namespace mse;
+
+namespace
+{
+
+struct KeyLess
+{
+  bool operator()(const FlatMetadata::value_type& entry, std::string_view key) const
+  {
+    return std::string_view(entry.first) < key;
+  }
+  bool operator()(std::string_view key, const FlatMetadata::value_type& entry) const
+  {
+    return key < std::string_view(entry.first);
+  }
+};
+
+} // namespace
+
+FlatMetadata::FlatMetadata()
+    : _arena(_buffer, sizeof(_buffer)), _entries(&_arena), _indexed_key_count(ContextKey::GetIndexedKeyCount())
+{
+  // claim the complete inline buffer at once so that growing up to inline_capacity never wastes arena space
+  _entries.reserve(inline_capacity);
+}
+
+FlatMetadata::FlatMetadata(std::initializer_list<value_type> entries) : FlatMetadata()
+{
+  insert(entries);
+}
+
+FlatMetadata::FlatMetadata(const FlatMetadata& other) : FlatMetadata()
+{
+  _entries = other._entries;
+  copyIndex(other);
+}
+
+FlatMetadata::FlatMetadata(FlatMetadata&& other) : FlatMetadata()
+{
+  *this = std::move(other);
+}
+
+FlatMetadata::~FlatMetadata()
+{
+}
+
+FlatMetadata& FlatMetadata::operator=(const FlatMetadata& other)
+{
+  if (this != &other)
+  {
+    // the allocator is not propagated, i.e. the entries are copied into this instance's arena
+    _entries = other._entries;
+    copyIndex(other);
+  }
+  return *this;
+}
+
+FlatMetadata& FlatMetadata::operator=(FlatMetadata&& other)
+{
+  if (this != &other)
+  {
+    // arenas differ, so the entries are moved one by one. Strings on the heap are stolen, not copied.
+    _entries = std::move(other._entries);
+    copyIndex(other);
+    other.clear();
+  }
+  return *this;
+}
+
+FlatMetadata& FlatMetadata::operator=(std::initializer_list<value_type> entries)
+{
+  clear();
+  insert(entries);
+  return *this;
+}
+
+void FlatMetadata::reserve(size_type capacity)
+{
+  _entries.reserve(capacity);
+}
+
+void FlatMetadata::clear()
+{
+  _entries.clear();
+  _indexed_key_count = ContextKey::GetIndexedKeyCount();
+  _first_positions.fill(0);
+  _present_id_count = 0;
+}
+
+FlatMetadata::const_iterator FlatMetadata::insert(const value_type& entry)
+{
+  return insert(value_type(entry));
+}
+
+FlatMetadata::const_iterator FlatMetadata::insert(value_type&& entry)
+{
+  const ContextKey::Id id = ContextKey::FindIndexed(entry.first);
+  return insert(std::move(entry), id);
+}
+
+FlatMetadata::const_iterator FlatMetadata::insert(value_type&& entry, ContextKey::Id id)
+{
+  const auto pos = upper_bound(entry.first);
+  const size_type index = static_cast<size_type>(std::distance(_entries.cbegin(), pos));
+  const auto cit = _entries.insert(pos, std::move(entry));
+  onInserted(index, id);
+  return cit;
+}
+
+void FlatMetadata::insert(std::initializer_list<value_type> entries)
+{
+  for (const value_type& entry : entries)
+  {
+    insert(entry);
+  }
+}
+
+FlatMetadata::const_iterator FlatMetadata::emplace(std::string key, std::string value)
+{
+  return insert(value_type(std::move(key), std::move(value)));
+}
+
+FlatMetadata::const_iterator FlatMetadata::emplace(const ContextKey& key, std::string value)
+{
+  return insert(value_type(key.str(), std::move(value)), key.IsIndexed() ? key.GetId() : ContextKey::invalid_id);
+}
+
+FlatMetadata::const_iterator FlatMetadata::erase(const_iterator pos)
+{
+  const size_type index = static_cast<size_type>(std::distance(_entries.cbegin(), pos));
+  onErased(index, index + 1);
+  return _entries.erase(pos);
+}
+
+FlatMetadata::size_type FlatMetadata::erase(std::string_view key)
+{
+  const auto [first, last] = equal_range(key);
+  const size_type first_index = static_cast<size_type>(std::distance(_entries.cbegin(), first));
+  const size_type erase_count = static_cast<size_type>(std::distance(first, last));
+  onErased(first_index, first_index + erase_count);
+  _entries.erase(first, last);
+  return erase_count;
+}
+
+FlatMetadata::const_iterator FlatMetadata::find(std::string_view key) const
+{
+  if (auto cit = lower_bound(key); cit != end() && cit->first == key)
+  {
+    return cit;
+  }
+  return end();
+}
+
+FlatMetadata::const_iterator FlatMetadata::find(const ContextKey& key) const
+{
+  if (key.GetId() < _indexed_key_count)
+  {
+    const std::uint32_t position = _first_positions[key.GetId()];
+    return position != 0 ? _entries.cbegin() + (position - 1) : end();
+  }
+  return find(key.str());
+}
+
+FlatMetadata::size_type FlatMetadata::count(std::string_view key) const
+{
+  const auto [first, last] = equal_range(key);
+  return static_cast<size_type>(std::distance(first, last));
+}
+
+FlatMetadata::const_iterator FlatMetadata::lower_bound(std::string_view key) const
+{
+  return std::lower_bound(_entries.cbegin(), _entries.cend(), key, KeyLess());
+}
+
+FlatMetadata::const_iterator FlatMetadata::upper_bound(std::string_view key) const
+{
+  return std::upper_bound(_entries.cbegin(), _entries.cend(), key, KeyLess());
+}
+
+std::pair<FlatMetadata::const_iterator, FlatMetadata::const_iterator> FlatMetadata::equal_range(
+    std::string_view key) const
+{
+  return std::equal_range(_entries.cbegin(), _entries.cend(), key, KeyLess());
+}
+
+bool FlatMetadata::operator==(const FlatMetadata& other) const
+{
+  return std::equal(_entries.cbegin(), _entries.cend(), other._entries.cbegin(), other._entries.cend());
+}
+
+bool FlatMetadata::operator!=(const FlatMetadata& other) const
+{
+  return !(*this == other);
+}
+
+void FlatMetadata::onInserted(size_type index, ContextKey::Id id)
+{
+  for (std::size_t i = 0; i < _present_id_count; ++i)
+  {
+    std::uint32_t& position = _first_positions[_present_ids[i]];
+    if (position > index) // entry has been shifted by the insertion
+    {
+      ++position;
+    }
+  }
+  if (id < _indexed_key_count && _first_positions[id] == 0) // entries with the same key are inserted at the end
+  {
+    _first_positions[id] = static_cast<std::uint32_t>(index + 1);
+    _present_ids[_present_id_count++] = id;
+  }
+}
+
+void FlatMetadata::onErased(size_type first, size_type last)
+{
+  // must be called before the entries in [first, last) are actually erased
+  for (std::size_t i = 0; i < _present_id_count;)
+  {
+    std::uint32_t& position = _first_positions[_present_ids[i]];
+    if (position > last)
+    {
+      position -= static_cast<std::uint32_t>(last - first);
+    }
+    else if (position > first)
+    {
+      // the first entry of that key is erased. Another one with the same key may follow the erased range.
+      const bool has_successor = last < _entries.size() && _entries[last].first == _entries[position - 1].first;
+      position = has_successor ? static_cast<std::uint32_t>(first + 1) : 0;
+      if (position == 0)
+      {
+        _present_ids[i] = _present_ids[--_present_id_count];
+        continue;
+      }
+    }
+    ++i;
+  }
+}
+
+void FlatMetadata::copyIndex(const FlatMetadata& other)
+{
+  _indexed_key_count = other._indexed_key_count;
+  _first_positions = other._first_positions;
+  _present_ids = other._present_ids;
+  _present_id_count = other._present_id_count;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+#include <microservice-essentials/context-key.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Sorted, contiguous multimap (string->string) that serves as the storage engine of mse::Context.
+ *
+ * Entries are kept in a vector sorted by key. Entries with equal keys keep their insertion order, i.e. find() returns
+ * the entry that has been inserted first. The vector lives in a per instance arena whose initial buffer is part of the
+ * object itself. Thus, building, looking up, and destroying the metadata of a typical request (up to inline_capacity
+ * entries) does not allocate except for strings that exceed the small string buffer. Larger metadata transparently
+ * spills over to the heap.
+ *
+ * Additionally, the position of the first entry of each indexed ContextKey is tracked, so that find() by ContextKey is
+ * O(1) and does not compare any strings. Maintaining the index costs an insert one hash of the key and an update of
+ * the positions of the indexed keys that are actually present.
+ *
+ * All lookups take a std::string_view (like a std::multimap with a transparent comparator), i.e. probing for a key
+ * never allocates a temporary std::string.
+ *
+ * The interface is a subset of std::multimap. In contrast to std::multimap, all iterators are invalidated by insert
+ * and erase and the entries cannot be modified through the iterators.
+ */
+class FlatMetadata
+{
+public:
+  typedef std::string key_type;
+  typedef std::string mapped_type;
+  typedef std::pair<std::string, std::string> value_type;
+  typedef std::size_t size_type;
+  typedef std::pmr::vector<value_type>::const_iterator const_iterator;
+  typedef const_iterator iterator;
+
+  static constexpr size_type inline_capacity = 16;
+
+  FlatMetadata();
+  FlatMetadata(std::initializer_list<value_type> entries);
+  template <typename InputIt> FlatMetadata(InputIt first, InputIt last);
+  FlatMetadata(const FlatMetadata& other);
+  FlatMetadata(FlatMetadata&& other);
+  ~FlatMetadata();
+
+  FlatMetadata& operator=(const FlatMetadata& other);
+  FlatMetadata& operator=(FlatMetadata&& other);
+  FlatMetadata& operator=(std::initializer_list<value_type> entries);
+
+  const_iterator begin() const
+  {
+    return _entries.cbegin();
+  }
+  const_iterator end() const
+  {
+    return _entries.cend();
+  }
+  const_iterator cbegin() const
+  {
+    return _entries.cbegin();
+  }
+  const_iterator cend() const
+  {
+    return _entries.cend();
+  }
+
+  bool empty() const
+  {
+    return _entries.empty();
+  }
+  size_type size() const
+  {
+    return _entries.size();
+  }
+  void reserve(size_type capacity);
+  void clear();
+
+  const_iterator insert(const value_type& entry);
+  const_iterator insert(value_type&& entry);
+  void insert(std::initializer_list<value_type> entries);
+  template <typename InputIt> void insert(InputIt first, InputIt last);
+  const_iterator emplace(std::string key, std::string value);
+  const_iterator emplace(const ContextKey& key, std::string value);
+
+  const_iterator erase(const_iterator pos);
+  size_type erase(std::string_view key);
+
+  const_iterator find(std::string_view key) const;
+  const_iterator find(const ContextKey& key) const;
+  size_type count(std::string_view key) const;
+  const_iterator lower_bound(std::string_view key) const;
+  const_iterator upper_bound(std::string_view key) const;
+  std::pair<const_iterator, const_iterator> equal_range(std::string_view key) const;
+
+  bool operator==(const FlatMetadata& other) const;
+  bool operator!=(const FlatMetadata& other) const;
+
+private:
+  const_iterator insert(value_type&& entry, ContextKey::Id id);
+  void onInserted(size_type index, ContextKey::Id id);
+  void onErased(size_type first, size_type last);
+  void copyIndex(const FlatMetadata& other);
+
+  alignas(value_type) std::byte _buffer[inline_capacity * sizeof(value_type)];
+  std::pmr::monotonic_buffer_resource _arena;
+  std::pmr::vector<value_type> _entries;
+  // only the keys that had been interned when this instance was constructed or cleared are indexed
+  std::size_t _indexed_key_count;
+  // index + 1 of the first entry of each indexed key, 0 if that key is not present
+  std::array<std::uint32_t, ContextKey::max_indexed_keys> _first_positions = {};
+  // ids of the indexed keys that are present, so that inserts and erases only update their positions
+  std::array<ContextKey::Id, ContextKey::max_indexed_keys> _present_ids = {};
+  std::size_t _present_id_count = 0;
+};
+
+template <typename InputIt> FlatMetadata::FlatMetadata(InputIt first, InputIt last) : FlatMetadata()
+{
+  insert(first, last);
+}
+
+template <typename InputIt> void FlatMetadata::insert(InputIt first, InputIt last)
+{
+  for (; first != last; ++first)
+  {
+    insert(value_type(first->first, first->second));
+  }
+}
+
+} // namespace mse
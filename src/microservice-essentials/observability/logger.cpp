@@ -1,5 +1,6 @@
 #include "logger.h"
 #include <iostream>
+#include <map>
 #include <regex>
 #include <unordered_map>
 
@@ -111,12 +112,17 @@ void Logger::Write(LogLevel level, std::string_view message)
 
 void Logger::Write(const Context& context, mse::LogLevel level, std::string_view message)
 {
-  if (static_cast<int>(level) >= static_cast<int>(_min_log_level))
+  if (IsEnabled(level))
   {
     write(context, level, message);
   }
 }
 
+bool Logger::IsEnabled(LogLevel level) const
+{
+  return static_cast<int>(level) >= static_cast<int>(_min_log_level);
+}
+
 Logger::Logger(LogLevel min_log_level) : _min_log_level(min_log_level)
 {
 }
@@ -156,6 +162,11 @@ DiscardLogger::~DiscardLogger()
 {
 }
 
+bool DiscardLogger::IsEnabled(LogLevel /*level*/) const
+{
+  return false;
+}
+
 void DiscardLogger::write(const mse::Context& /*context*/, mse::LogLevel /*level*/, std::string_view /*message*/)
 {
 }
@@ -177,20 +188,26 @@ std::ostream& operator<<(std::ostream& os, const mse::LogLevel& level)
 
 std::string StructuredLogger::to_json(const mse::Context& context, const std::vector<std::string>* fields)
 {
-  Context::Metadata metadata = fields != nullptr ? context.GetFilteredMetadata(*fields) : context.GetAllMetadata();
-
   // TODO: escaping. See:
   // https://stackoverflow.com/questions/19176024/how-to-escape-special-characters-in-building-a-json-string
   std::string json = "{";
   bool is_first = true;
-  for (const auto& key_value_pair : metadata)
-  {
+  const Context::MetadataVisitor append_to_json = [&](const std::string& key, const std::string& value) {
     if (!is_first)
     {
       json += ",";
     }
     is_first = false;
-    json += std::string("\"") + json_escape(key_value_pair.first) + "\":\"" + json_escape(key_value_pair.second) + "\"";
+    json += std::string("\"") + json_escape(key) + "\":\"" + json_escape(value) + "\"";
+  };
+
+  if (fields != nullptr)
+  {
+    context.VisitFilteredMetadata(*fields, append_to_json);
+  }
+  else
+  {
+    context.VisitAllMetadata(append_to_json);
   }
   json += "}";
   return json;
@@ -207,6 +224,12 @@ StructuredLogger::~StructuredLogger()
 {
 }
 
+bool StructuredLogger::IsEnabled(LogLevel level) const
+{
+  // don't format messages that would be discarded by the backend anyway
+  return Logger::IsEnabled(level) && _logger_backend.IsEnabled(level);
+}
+
 void StructuredLogger::write(const mse::Context& context, mse::LogLevel level, std::string_view message)
 {
   mse::Context context_with_message({{"message", std::string(message)}, {"level", to_string(level)}}, &context);
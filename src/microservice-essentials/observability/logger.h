@@ -7,12 +7,24 @@
 #include <string_view>
 #include <vector>
 
-#define MSE_LOG_TRACE(m) mse::LogProvider::GetLogger().Write(MSE_LOCAL_CONTEXT, mse::LogLevel::trace, m);
-#define MSE_LOG_DEBUG(m) mse::LogProvider::GetLogger().Write(MSE_LOCAL_CONTEXT, mse::LogLevel::debug, m);
-#define MSE_LOG_INFO(m) mse::LogProvider::GetLogger().Write(MSE_LOCAL_CONTEXT, mse::LogLevel::info, m);
-#define MSE_LOG_WARN(m) mse::LogProvider::GetLogger().Write(MSE_LOCAL_CONTEXT, mse::LogLevel::warn, m);
-#define MSE_LOG_ERROR(m) mse::LogProvider::GetLogger().Write(MSE_LOCAL_CONTEXT, mse::LogLevel::err, m);
-#define MSE_LOG_CRITICAL(m) mse::LogProvider::GetLogger().Write(MSE_LOCAL_CONTEXT, mse::LogLevel::critical, m);
+// the log level is checked before the local context and the message are constructed, i.e. log statements below the
+// minimum log level are (almost) free. Like before, the MSE_LOG_* macros expand to a complete statement including the
+// semicolon, i.e. existing call sites with or without a trailing semicolon keep compiling.
+#define MSE_LOG(level, m)                                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (mse::Logger& mse_logger = mse::LogProvider::GetLogger(); mse_logger.IsEnabled(level))                          \
+    {                                                                                                                  \
+      mse_logger.Write(MSE_LOCAL_CONTEXT, level, m);                                                                   \
+    }                                                                                                                  \
+  } while (false)
+
+#define MSE_LOG_TRACE(m) MSE_LOG(mse::LogLevel::trace, m);
+#define MSE_LOG_DEBUG(m) MSE_LOG(mse::LogLevel::debug, m);
+#define MSE_LOG_INFO(m) MSE_LOG(mse::LogLevel::info, m);
+#define MSE_LOG_WARN(m) MSE_LOG(mse::LogLevel::warn, m);
+#define MSE_LOG_ERROR(m) MSE_LOG(mse::LogLevel::err, m);
+#define MSE_LOG_CRITICAL(m) MSE_LOG(mse::LogLevel::critical, m);
 
 namespace mse
 {
@@ -46,6 +58,9 @@ public:
   void Write(LogLevel level, std::string_view message);
   void Write(const Context& context, mse::LogLevel level, std::string_view message);
 
+  // returns true if a message with the given level would actually be written
+  virtual bool IsEnabled(LogLevel level) const;
+
 protected:
   Logger(LogLevel min_log_level);
   virtual ~Logger();
@@ -111,6 +126,8 @@ public:
   DiscardLogger();
   virtual ~DiscardLogger();
 
+  virtual bool IsEnabled(LogLevel level) const override;
+
   virtual void write(const mse::Context& context, mse::LogLevel level, std::string_view message) override;
 };
 
@@ -129,6 +146,8 @@ public:
                    Formatter formatter = to_json);
   virtual ~StructuredLogger();
 
+  virtual bool IsEnabled(LogLevel level) const override;
+
   virtual void write(const mse::Context& context, mse::LogLevel level, std::string_view message) override;
 
   // include opentelemetry fields
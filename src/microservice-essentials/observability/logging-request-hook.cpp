@@ -20,7 +20,8 @@ LoggingRequestHook::LoggingRequestHook(const Parameters& parameters) : RequestHo
 Status LoggingRequestHook::pre_process(Context& context)
 {
   mse::LogProvider::GetLogger().Write(context, _parameters.loglevel_success,
-                                      get_request_verb_pre() + " request " + context.AtOr("request", "unknown"));
+                                      get_request_verb_pre() + " request " +
+                                          context.AtOr(ContextKey::request, "unknown"));
   return Status::OK;
 }
 
@@ -28,8 +29,8 @@ Status LoggingRequestHook::post_process(Context& context, Status status)
 {
   mse::LogProvider::GetLogger().Write(
       context, status ? _parameters.loglevel_success : _parameters.loglevel_failure,
-      std::string("request ") + context.AtOr("request", "unknown") + " " + get_request_verb_post() + " with status " +
-          mse::to_string(status.code) +
+      std::string("request ") + context.AtOr(ContextKey::request, "unknown") + " " + get_request_verb_post() +
+          " with status " + mse::to_string(status.code) +
           (status.details.empty() ? std::string("") : (std::string(" (") + status.details + ")")));
   return status;
 }
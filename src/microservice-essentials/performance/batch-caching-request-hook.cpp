@@ -0,0 +1,190 @@
+#include "batch-caching-request-hook.h"
+
+using namespace mse;
+
+BatchCachingRequestHook::Parameters::Parameters(std::shared_ptr<Cache> cache_) : cache(cache_)
+{
+}
+
+BatchCachingRequestHook::Parameters&
+BatchCachingRequestHook::Parameters::WithKeyGenerator(const BatchCacheKeyGen& key_generator_)
+{
+  key_generator = key_generator_;
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters&
+BatchCachingRequestHook::Parameters::WithKeys(const std::vector<std::string>& keys_)
+{
+  key_generator = [keys_]() -> std::vector<std::string> { return keys_; };
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::WithCacheReader(BatchCacheReader reader_)
+{
+  cache_reader = reader_;
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::WithCacheWriter(BatchCacheWriter writer_)
+{
+  cache_writer = writer_;
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters&
+BatchCachingRequestHook::Parameters::WithMissHandler(BatchMissHandler miss_handler_)
+{
+  miss_handler = miss_handler_;
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters&
+BatchCachingRequestHook::Parameters::WithMissingIndices(std::vector<std::size_t>& missing_indices_)
+{
+  miss_handler = [&missing_indices_](const std::vector<std::size_t>& missing_indices) {
+    missing_indices_ = missing_indices;
+  };
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::WithMaxAge(const Duration& max_age_)
+{
+  max_age = max_age_;
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::NeverExpire()
+{
+  return WithMaxAge(Duration::max());
+}
+
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::WithWeigher(CacheWeigher weigher_)
+{
+  weigher = weigher_;
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters&
+BatchCachingRequestHook::Parameters::WithStatistics(std::shared_ptr<CacheStatistics> statistics_)
+{
+  statistics = statistics_;
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::Include(const StatusCode& status_code_)
+{
+  status_codes_to_cache.insert(status_code_);
+  return *this;
+}
+
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::Exclude(const StatusCode& status_code_)
+{
+  status_codes_to_cache.erase(status_code_);
+  return *this;
+}
+
+BatchCachingRequestHook::BatchCachingRequestHook(const Parameters& parameters)
+    : mse::RequestHook("batch caching"), _parameters(parameters)
+{
+}
+
+BatchCachingRequestHook::~BatchCachingRequestHook()
+{
+}
+
+Status BatchCachingRequestHook::Process(Func func, Context& context)
+{
+  const auto [keys, missing_indices] = readFromCache();
+  if (missing_indices.empty())
+  {
+    return Status::OK;
+  }
+
+  if (_parameters.miss_handler)
+  {
+    _parameters.miss_handler(missing_indices);
+  }
+  const Cache::TimePoint load_start_time = Cache::Clock::now();
+  Status status = func(context);
+  writeToCache(keys, missing_indices, status, load_start_time);
+  return status;
+}
+
+void BatchCachingRequestHook::ProcessAsync(AsyncFunc func, Context& context, Continuation continuation)
+{
+  auto [keys, missing_indices] = readFromCache();
+  if (missing_indices.empty())
+  {
+    continuation(Status::OK);
+    return;
+  }
+
+  if (_parameters.miss_handler)
+  {
+    _parameters.miss_handler(missing_indices);
+  }
+  func(context, [this, keys = std::move(keys), missing_indices = std::move(missing_indices), continuation,
+                 load_start_time = Cache::Clock::now()](Status status) {
+    writeToCache(keys, missing_indices, status, load_start_time);
+    continuation(status);
+  });
+}
+
+std::pair<std::vector<std::string>, std::vector<std::size_t>> BatchCachingRequestHook::readFromCache() const
+{
+  std::vector<std::string> keys = _parameters.key_generator();
+  const std::vector<std::shared_ptr<const Cache::Element>> elements = _parameters.cache->GetMany(keys);
+  std::vector<std::size_t> missing_indices;
+  const Cache::TimePoint now = Cache::Clock::now();
+  for (std::size_t i = 0; i < elements.size(); ++i)
+  {
+    if (elements[i] != nullptr && now - elements[i]->insertion_time <= _parameters.max_age)
+    {
+      _parameters.cache_reader(i, elements[i]->data);
+    }
+    else
+    {
+      missing_indices.push_back(i); // expired elements are replaced by InsertMany
+    }
+  }
+  if (_parameters.statistics != nullptr)
+  {
+    _parameters.statistics->RecordHit(keys.size() - missing_indices.size());
+    _parameters.statistics->RecordMiss(missing_indices.size());
+  }
+  return {std::move(keys), std::move(missing_indices)};
+}
+
+void BatchCachingRequestHook::writeToCache(const std::vector<std::string>& keys,
+                                           const std::vector<std::size_t>& missing_indices, const Status& status,
+                                           const Cache::TimePoint& load_start_time) const
+{
+  const Cache::TimePoint now = Cache::Clock::now();
+  if (_parameters.statistics != nullptr)
+  {
+    _parameters.statistics->RecordLoadTime(now - load_start_time);
+  }
+  if (_parameters.status_codes_to_cache.find(status.code) == _parameters.status_codes_to_cache.end())
+  {
+    return;
+  }
+
+  const Cache::TimePoint expiry_time = impl::getExpiryTime(now, _parameters.max_age);
+  std::vector<std::pair<std::string, Cache::Element>> elements;
+  elements.reserve(missing_indices.size());
+  for (std::size_t index : missing_indices)
+  {
+    Cache::Element element{_parameters.cache_writer(index), status, now, expiry_time};
+    if (!element.data.has_value())
+    {
+      continue; // e.g. not found
+    }
+    element.weight = _parameters.weigher(element.data);
+    elements.emplace_back(keys.at(index), std::move(element));
+  }
+  if (!elements.empty())
+  {
+    _parameters.cache->InsertMany(elements);
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <any>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <microservice-essentials/performance/cache-statistics.h>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <microservice-essentials/request/request-hook-factory.h>
+#include <microservice-essentials/request/request-hook.h>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mse
+{
+
+using BatchCacheKeyGen = std::function<std::vector<std::string>()>;            // generates a key per item
+using BatchCacheReader = std::function<void(std::size_t, const std::any&)>;    // restores the item with the index
+using BatchCacheWriter = std::function<std::any(std::size_t)>;                 // returns the item's data or nothing
+using BatchMissHandler = std::function<void(const std::vector<std::size_t>&)>; // receives the indices of the misses
+
+/**
+ * Request hook for requests that consist of several items, e.g. the status of each star ship in a list.
+ * All items are looked up with one Cache::GetMany call. If items are missing, the function is executed once for all of
+ * them, i.e. it has to request the missing items only (see WithMissingIndices). They are inserted with one
+ * Cache::InsertMany call, if the function's status is cacheable. If all items are cached, the function is not executed
+ * and the status is ok.
+ */
+class BatchCachingRequestHook : public mse::RequestHook
+{
+public:
+  struct Parameters
+  {
+    using Duration = std::chrono::duration<double, std::milli>;
+
+    Parameters(std::shared_ptr<Cache> cache_);
+
+    Parameters& WithKeyGenerator(const BatchCacheKeyGen& key_generator_);
+    Parameters& WithKeys(const std::vector<std::string>& keys_);
+
+    Parameters& WithCacheReader(BatchCacheReader reader_);
+    Parameters& WithCacheWriter(BatchCacheWriter writer_);
+    // sets writer and reader to store and restore the objects, which must have an element per key
+    template <typename T> Parameters& WithCachedObjects(std::vector<T>& objects);
+    // same as above, but objects without a value (e.g. not found) are not cached
+    template <typename T> Parameters& WithCachedObjects(std::vector<std::optional<T>>& objects);
+
+    Parameters& WithMissHandler(BatchMissHandler miss_handler_);
+    Parameters& WithMissingIndices(std::vector<std::size_t>& missing_indices_); // set before the function is executed
+
+    Parameters& WithMaxAge(const Duration& max_age_);
+    Parameters& NeverExpire(); // same as WithMaxAge(std::chrono::duration<double>::max())
+    Parameters& WithWeigher(CacheWeigher weigher_);
+    Parameters& WithStatistics(std::shared_ptr<CacheStatistics> statistics_); // records hits, misses and load times
+
+    Parameters& Include(const StatusCode& status_code_);
+    Parameters& Exclude(const StatusCode& status_code_);
+
+    std::shared_ptr<Cache> cache;
+    BatchCacheKeyGen key_generator;
+    BatchCacheReader cache_reader;
+    BatchCacheWriter cache_writer;
+    BatchMissHandler miss_handler;
+    Duration max_age = std::chrono::minutes(10);
+    std::unordered_set<StatusCode> status_codes_to_cache = {StatusCode::ok};
+    CacheWeigher weigher = CachingRequestHook::Parameters::DefaultWeigher;
+    std::shared_ptr<CacheStatistics> statistics;
+
+    AutoRequestHookParameterRegistration<BatchCachingRequestHook::Parameters, BatchCachingRequestHook>
+        auto_registration;
+  };
+
+  BatchCachingRequestHook(const Parameters& parameters);
+  virtual ~BatchCachingRequestHook();
+
+  virtual Status Process(Func func, Context& context) override;
+  virtual void ProcessAsync(AsyncFunc func, Context& context, Continuation continuation) override;
+
+private:
+  // restores the cached items, returns the keys and the indices of the missing items
+  std::pair<std::vector<std::string>, std::vector<std::size_t>> readFromCache() const;
+  void writeToCache(const std::vector<std::string>& keys, const std::vector<std::size_t>& missing_indices,
+                    const Status& status, const Cache::TimePoint& load_start_time) const;
+
+  Parameters _parameters;
+};
+
+} // namespace mse
+
+#include <microservice-essentials/performance/batch-caching-request-hook.txx>
@@ -0,0 +1,30 @@
+#include <microservice-essentials/performance/batch-caching-request-hook.h>
+
+namespace mse
+{
+
+template <typename T>
+BatchCachingRequestHook::Parameters& BatchCachingRequestHook::Parameters::WithCachedObjects(std::vector<T>& objects)
+{
+  cache_reader = [&objects](std::size_t index, const std::any& data) {
+    objects.at(index) = std::any_cast<const T&>(data);
+  };
+  cache_writer = [&objects](std::size_t index) -> std::any { return T(objects.at(index)); };
+  return *this;
+}
+
+template <typename T>
+BatchCachingRequestHook::Parameters&
+BatchCachingRequestHook::Parameters::WithCachedObjects(std::vector<std::optional<T>>& objects)
+{
+  cache_reader = [&objects](std::size_t index, const std::any& data) {
+    objects.at(index) = std::any_cast<const T&>(data);
+  };
+  cache_writer = [&objects](std::size_t index) -> std::any {
+    const std::optional<T>& object = objects.at(index);
+    return object.has_value() ? std::any(T(object.value())) : std::any();
+  };
+  return *this;
+}
+
+} // namespace mse
@@ -0,0 +1,116 @@
+#include "cache-statistics.h"
+#include <microservice-essentials/observability/logger.h>
+#include <sstream>
+#include <stdexcept>
+
+using namespace mse;
+
+double CacheStatistics::Snapshot::HitRatio() const
+{
+  const std::uint64_t requests = hits + misses;
+  return requests == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(requests);
+}
+
+CacheStatistics::~CacheStatistics()
+{
+  {
+    std::lock_guard lock(_logging_mutex);
+    _stop_logging = true;
+  }
+  _logging_condition.notify_all();
+  if (_logging_thread.joinable())
+  {
+    _logging_thread.join();
+  }
+}
+
+void CacheStatistics::RecordHit(std::uint64_t count)
+{
+  _hits.value.fetch_add(count, std::memory_order_relaxed);
+}
+
+void CacheStatistics::RecordMiss(std::uint64_t count)
+{
+  _misses.value.fetch_add(count, std::memory_order_relaxed);
+}
+
+void CacheStatistics::RecordExpiration(std::uint64_t count)
+{
+  _expirations.value.fetch_add(count, std::memory_order_relaxed);
+}
+
+void CacheStatistics::RecordEviction(std::uint64_t count)
+{
+  _evictions.value.fetch_add(count, std::memory_order_relaxed);
+}
+
+void CacheStatistics::RecordInsert(std::uint64_t count)
+{
+  _inserts.value.fetch_add(count, std::memory_order_relaxed);
+}
+
+void CacheStatistics::AddToSize(std::int64_t delta)
+{
+  _size.fetch_add(delta, std::memory_order_relaxed);
+}
+
+void CacheStatistics::RecordLoadTime(const Duration& load_time)
+{
+  std::size_t bucket = 0;
+  for (double upper_bound = 1.0; bucket + 1 < LoadTimeBucketCount && load_time.count() >= upper_bound;
+       upper_bound *= 2.0)
+  {
+    ++bucket;
+  }
+  _load_time_histogram[bucket].value.fetch_add(1, std::memory_order_relaxed);
+}
+
+CacheStatistics::Snapshot CacheStatistics::GetSnapshot() const
+{
+  Snapshot snapshot;
+  snapshot.hits = _hits.value.load(std::memory_order_relaxed);
+  snapshot.misses = _misses.value.load(std::memory_order_relaxed);
+  snapshot.expirations = _expirations.value.load(std::memory_order_relaxed);
+  snapshot.evictions = _evictions.value.load(std::memory_order_relaxed);
+  snapshot.inserts = _inserts.value.load(std::memory_order_relaxed);
+  snapshot.size = _size.load(std::memory_order_relaxed);
+  for (std::size_t i = 0; i < LoadTimeBucketCount; ++i)
+  {
+    snapshot.load_time_histogram[i] = _load_time_histogram[i].value.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void CacheStatistics::StartLogging(const std::string& cache_name, const Duration& interval)
+{
+  std::lock_guard lock(_logging_mutex);
+  if (_logging_thread.joinable())
+  {
+    throw std::logic_error("logging has already been started");
+  }
+  _logging_thread = std::thread([this, cache_name, interval]() {
+    std::unique_lock lock(_logging_mutex);
+    while (!_logging_condition.wait_for(lock, interval, [this]() { return _stop_logging; }))
+    {
+      MSE_LOG_INFO("statistics of cache '" + cache_name + "': " + to_string(GetSnapshot()));
+    }
+  });
+}
+
+std::string mse::to_string(const CacheStatistics::Snapshot& snapshot)
+{
+  std::ostringstream stream;
+  stream << "hits: " << snapshot.hits << ", misses: " << snapshot.misses << ", hit ratio: " << snapshot.HitRatio()
+         << ", expirations: " << snapshot.expirations << ", evictions: " << snapshot.evictions
+         << ", inserts: " << snapshot.inserts << ", size: " << snapshot.size << ", load times:";
+  for (std::size_t i = 0; i < CacheStatistics::LoadTimeBucketCount; ++i)
+  {
+    if (snapshot.load_time_histogram[i] != 0) // empty buckets are omitted to keep the message short
+    {
+      stream << (i + 1 < CacheStatistics::LoadTimeBucketCount ? " <" : " >=")
+             << (std::uint64_t(1) << (i + 1 < CacheStatistics::LoadTimeBucketCount ? i : i - 1))
+             << "ms: " << snapshot.load_time_histogram[i];
+    }
+  }
+  return stream.str();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace mse
+{
+
+/**
+ * Lock-free counters that describe how well a cache performs, e.g. to tune max ages and cache sizes.
+ * Caches (see Cache::SetStatistics) record the operations on their storage, CachingRequestHooks (see
+ * CachingRequestHook::Parameters::WithStatistics) record the outcome of requests including the time it took to load
+ * missing elements. Hooks and caches should not share a statistics object, as both count hits and misses.
+ */
+class CacheStatistics
+{
+public:
+  using Duration = std::chrono::duration<double, std::milli>;
+
+  // bucket i counts load times below 2^i ms, the last bucket counts all longer load times
+  static constexpr std::size_t LoadTimeBucketCount = 16;
+
+  struct Snapshot
+  {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t expirations = 0;
+    std::uint64_t evictions = 0;
+    std::uint64_t inserts = 0;
+    std::int64_t size = 0;
+    std::array<std::uint64_t, LoadTimeBucketCount> load_time_histogram = {};
+
+    double HitRatio() const; // 0 if there have not been any requests
+  };
+
+  CacheStatistics() = default;
+  ~CacheStatistics();
+
+  void RecordHit(std::uint64_t count = 1);
+  void RecordMiss(std::uint64_t count = 1);
+  void RecordExpiration(std::uint64_t count = 1);
+  void RecordEviction(std::uint64_t count = 1);
+  void RecordInsert(std::uint64_t count = 1);
+  void AddToSize(std::int64_t delta);
+  void RecordLoadTime(const Duration& load_time);
+
+  Snapshot GetSnapshot() const; // the counters are read one after the other, not atomically as a whole
+
+  // logs a snapshot with the given interval until destruction
+  void StartLogging(const std::string& cache_name, const Duration& interval);
+
+private:
+  struct alignas(64) Counter // aligned to a cache line, so that updating one counter does not slow down the others
+  {
+    std::atomic<std::uint64_t> value = 0;
+  };
+
+  Counter _hits;
+  Counter _misses;
+  Counter _expirations;
+  Counter _evictions;
+  Counter _inserts;
+  alignas(64) std::atomic<std::int64_t> _size = 0;
+  std::array<Counter, LoadTimeBucketCount> _load_time_histogram;
+
+  std::mutex _logging_mutex;
+  std::condition_variable _logging_condition;
+  bool _stop_logging = false;
+  std::thread _logging_thread;
+};
+
+std::string to_string(const CacheStatistics::Snapshot& snapshot);
+
+} // namespace mse
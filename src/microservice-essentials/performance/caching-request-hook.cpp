@@ -1,8 +1,125 @@
 #include "caching-request-hook.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <microservice-essentials/observability/logger.h>
 #include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 using namespace mse;
 
+namespace
+{
+struct Lifetime
+{
+  CachingRequestHook::Parameters::Duration max_age;
+  CachingRequestHook::Parameters::Duration stale_duration;
+  double refresh_ahead_fraction;
+};
+
+Lifetime getLifetime(const CachingRequestHook::Parameters& parameters, const StatusCode& status_code)
+{
+  if (auto it = parameters.status_code_max_ages.find(status_code); it != parameters.status_code_max_ages.end())
+  {
+    if (status_code == StatusCode::ok)
+    {
+      return Lifetime{it->second, parameters.stale_duration, parameters.refresh_ahead_fraction};
+    }
+    return Lifetime{it->second, CachingRequestHook::Parameters::Duration::zero(), 1.0}; // errors never outlive it
+  }
+  return Lifetime{parameters.max_age, parameters.stale_duration, parameters.refresh_ahead_fraction};
+}
+
+// the hook does not use elements after max age and stale duration, so the cache may reclaim them
+Cache::TimePoint getExpiryTime(const Cache::TimePoint& insertion_time, const Lifetime& lifetime)
+{
+  return impl::getExpiryTime(insertion_time, lifetime.max_age + lifetime.stale_duration);
+}
+
+// returns the positions of the items ordered by their shard, so that each shard is locked once per batch
+std::vector<std::size_t> orderByShard(const std::vector<std::size_t>& shard_indices)
+{
+  std::vector<std::size_t> positions(shard_indices.size());
+  for (std::size_t i = 0; i < positions.size(); ++i)
+  {
+    positions[i] = i;
+  }
+  std::stable_sort(positions.begin(), positions.end(), [&shard_indices](std::size_t lhs, std::size_t rhs) {
+    return shard_indices[lhs] < shard_indices[rhs];
+  });
+  return positions;
+}
+
+/**
+ * Borrows a key buffer of the calling thread while a request is processed, nested requests borrow different buffers.
+ * The buffers keep their capacity, so that writing keys does not allocate once they have grown.
+ */
+class ScopedKeyBuffer
+{
+public:
+  ScopedKeyBuffer() : _buffers(getBuffers())
+  {
+    if (_buffers.depth == _buffers.keys.size())
+    {
+      _buffers.keys.emplace_back(); // a deque keeps the buffers of enclosing requests in place
+    }
+    _key = &_buffers.keys[_buffers.depth++];
+    _key->clear();
+  }
+  ~ScopedKeyBuffer()
+  {
+    --_buffers.depth;
+  }
+  ScopedKeyBuffer(const ScopedKeyBuffer&) = delete;
+  ScopedKeyBuffer& operator=(const ScopedKeyBuffer&) = delete;
+
+  std::string& Get()
+  {
+    return *_key;
+  }
+
+private:
+  struct Buffers
+  {
+    std::deque<std::string> keys;
+    std::size_t depth = 0;
+  };
+  static Buffers& getBuffers()
+  {
+    thread_local Buffers buffers;
+    return buffers;
+  }
+
+  Buffers& _buffers;
+  std::string* _key;
+};
+
+} // namespace
+
+struct CachingRequestHook::Flight
+{
+  struct Registry
+  {
+    std::mutex mutex;
+    std::map<std::pair<const Cache*, std::string>, std::shared_ptr<Flight>> flights;
+  };
+  static Registry& GetRegistry()
+  {
+    static Registry registry;
+    return registry;
+  }
+
+  std::mutex mutex;
+  std::condition_variable landed;
+  std::optional<FlightResult> result;                            // set on landing
+  std::vector<std::function<void(const FlightResult&)>> waiters; // asynchronously processed requests
+};
+
 const Cache::Element Cache::InvalidElement{std::any(), Status{StatusCode::unknown, "invalid cached element"},
                                            Cache::TimePoint::min()};
 bool Cache::IsValid(const Element& element)
@@ -10,25 +127,78 @@ bool Cache::IsValid(const Element& element)
   return element.data.has_value();
 }
 
+std::shared_ptr<const Cache::Element> Cache::GetShared(const std::string& key) const
+{
+  if (Element element = Get(key); IsValid(element))
+  {
+    return std::make_shared<const Element>(std::move(element));
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const Cache::Element> Cache::Peek(const std::string& key) const
+{
+  return GetShared(key);
+}
+
+std::vector<std::shared_ptr<const Cache::Element>> Cache::GetMany(const std::vector<std::string>& keys) const
+{
+  std::vector<std::shared_ptr<const Element>> elements;
+  elements.reserve(keys.size());
+  for (const std::string& key : keys)
+  {
+    elements.push_back(GetShared(key));
+  }
+  return elements;
+}
+
+void Cache::InsertMany(const std::vector<std::pair<std::string, Element>>& elements)
+{
+  for (const auto& [key, element] : elements)
+  {
+    Insert(key, element);
+  }
+}
+
+void Cache::SetStatistics(std::shared_ptr<CacheStatistics> statistics)
+{
+  _statistics = statistics;
+}
+
+std::shared_ptr<CacheStatistics> Cache::GetStatistics() const
+{
+  return _statistics;
+}
+
 CachingRequestHook::Parameters::Parameters(std::shared_ptr<Cache> cache_) : cache(cache_)
 {
 }
 
 CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithConstantResponse()
 {
-  key_generator = []() -> std::string { return std::string{}; };
+  key_generator = nullptr;
+  key_writer = [](std::string&) {};
   return *this;
 }
 
 CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithKeyGenerator(const CacheKeyGen& key_generator_)
 {
   key_generator = key_generator_;
+  key_writer = nullptr;
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithKeyWriter(const CacheKeyWriter& key_writer_)
+{
+  key_generator = nullptr;
+  key_writer = key_writer_;
   return *this;
 }
 
 CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithKey(const std::string& key_)
 {
-  key_generator = [key_]() -> std::string { return key_; };
+  key_generator = nullptr;
+  key_writer = [key_](std::string& key) { key.append(key_); };
   return *this;
 }
 
@@ -55,6 +225,24 @@ CachingRequestHook::Parameters& CachingRequestHook::Parameters::NeverExpire()
   return WithMaxAge(Duration::max());
 }
 
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithMaxAge(const StatusCode& status_code_,
+                                                                           const Duration& max_age_)
+{
+  status_codes_to_cache.insert(status_code_);
+  status_code_max_ages[status_code_] = max_age_;
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithMaxAge(
+    const std::initializer_list<StatusCode>& status_codes_, const Duration& max_age_)
+{
+  for (const StatusCode& status_code : status_codes_)
+  {
+    WithMaxAge(status_code, max_age_);
+  }
+  return *this;
+}
+
 CachingRequestHook::Parameters& CachingRequestHook::Parameters::IncludeAllStatusCodes()
 {
   for (int status_code_as_int = static_cast<int>(mse::StatusCode::lowest);
@@ -97,9 +285,91 @@ CachingRequestHook::Parameters& CachingRequestHook::Parameters::Exclude(
   return *this;
 }
 
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithRequestCoalescing(const Duration& wait_timeout_)
+{
+  coalesce_requests = true;
+  coalescing_wait_timeout = wait_timeout_;
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithStaleWhileRevalidate(
+    const Duration& stale_duration_)
+{
+  stale_duration = stale_duration_;
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithRefreshAhead(double fraction_)
+{
+  refresh_ahead_fraction = fraction_;
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithBackgroundRefresh(
+    CacheRefresher refresher_, std::shared_ptr<Executor> executor_)
+{
+  if (executor_ == nullptr)
+  {
+    // refreshing on the request thread would add the upstream latency to the stale hit that it is meant to avoid
+    throw std::invalid_argument("background refresh requires an executor");
+  }
+  refresher = refresher_;
+  refresh_executor = executor_;
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithWeigher(CacheWeigher weigher_)
+{
+  weigher = weigher_;
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithTags(const std::vector<std::string>& tags_)
+{
+  tag_generator = [tags_]() -> std::vector<std::string> { return tags_; };
+  return *this;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithTagGenerator(const CacheTagGen& tag_generator_)
+{
+  tag_generator = tag_generator_;
+  return *this;
+}
+
+std::size_t CachingRequestHook::Parameters::DefaultWeigher(const std::any& data)
+{
+  if (const std::string* string_data = std::any_cast<std::string>(&data); string_data != nullptr)
+  {
+    return string_data->size();
+  }
+  if (const auto* shared_string_data = std::any_cast<std::shared_ptr<const std::string>>(&data);
+      shared_string_data != nullptr && *shared_string_data != nullptr)
+  {
+    return (*shared_string_data)->size();
+  }
+  return 1;
+}
+
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithStatistics(
+    std::shared_ptr<CacheStatistics> statistics_)
+{
+  statistics = statistics_;
+  return *this;
+}
+
 CachingRequestHook::CachingRequestHook(const Parameters& parameters)
     : mse::RequestHook("caching"), _parameters(parameters)
 {
+  if (_parameters.refresher != nullptr && _parameters.refresh_executor == nullptr)
+  {
+    throw std::invalid_argument("background refresh requires an executor"); // e.g. the refresher was set directly
+  }
+  if (!_parameters.key_writer && _parameters.key_generator)
+  {
+    _parameters.key_writer = [key_generator = _parameters.key_generator](std::string& key) {
+      key.append(key_generator());
+    };
+  }
 }
 
 CachingRequestHook::~CachingRequestHook()
@@ -108,52 +378,556 @@ CachingRequestHook::~CachingRequestHook()
 
 Status CachingRequestHook::Process(Func func, Context& context)
 {
-  std::string key = _parameters.key_generator();
+  ScopedKeyBuffer key_buffer;
+  _parameters.key_writer(key_buffer.Get());
+  const std::string& key = key_buffer.Get();
+  std::shared_ptr<Flight> flight; // set if this request has to land it
+  if (std::optional<Status> cached_status = readFromCache(key, flight); cached_status.has_value())
+  {
+    return cached_status.value();
+  }
 
-  if (Cache::Element element = _parameters.cache->Get(key); Cache::IsValid(element))
+  // cache miss
+  if (flight == nullptr && _parameters.coalesce_requests)
   {
-    if ((Cache::Clock::now() - element.insertion_time) <= _parameters.max_age)
+    auto [joined_flight, is_first] = joinFlight(_parameters.cache.get(), key);
+    if (is_first)
     {
-      // cache hit
-      _parameters.cache_reader(element.data);
-      return element.status;
+      flight = joined_flight;
     }
-    else
+    else if (std::optional<Status> status = waitForFlight(*joined_flight); status.has_value())
     {
-      // cache expired
-      _parameters.cache->Remove(key);
+      return status.value();
     }
   }
+  const Cache::TimePoint load_start_time = Cache::Clock::now();
+  if (flight == nullptr)
+  {
+    Status status = func(context);
+    recordLoadTime(load_start_time);
+    writeToCache(key, status);
+    return status;
+  }
 
-  // cache miss
-  Status status = func(context);
-  if (_parameters.status_codes_to_cache.find(status.code) != _parameters.status_codes_to_cache.end())
+  Status status;
+  Cache::Element result;
+  try
   {
-    _parameters.cache->Insert(key, Cache::Element{_parameters.cache_writer(), status, Cache::Clock::now()});
+    status = func(context);
+    recordLoadTime(load_start_time);
+    result = writeToCache(key, status);
   }
+  catch (...)
+  {
+    landFlight(_parameters.cache.get(), key, flight, std::nullopt);
+    throw;
+  }
+  landFlight(_parameters.cache.get(), key, flight, std::move(result));
   return status;
 }
 
+void CachingRequestHook::ProcessAsync(AsyncFunc func, Context& context, Continuation continuation)
+{
+  ScopedKeyBuffer key_buffer;
+  _parameters.key_writer(key_buffer.Get());
+  std::shared_ptr<Flight> flight; // set if this request has to land it
+  if (std::optional<Status> cached_status = readFromCache(key_buffer.Get(), flight); cached_status.has_value())
+  {
+    continuation(cached_status.value());
+    return;
+  }
+
+  // cache miss, the continuations might be called after the key buffer has been returned
+  const std::string key = key_buffer.Get();
+  auto process = [this, func, &context, key, continuation]() {
+    func(context, [this, key, continuation, load_start_time = Cache::Clock::now()](Status status) {
+      recordLoadTime(load_start_time);
+      writeToCache(key, status);
+      continuation(status);
+    });
+  };
+  if (flight == nullptr && _parameters.coalesce_requests)
+  {
+    auto [joined_flight, is_first] = joinFlight(_parameters.cache.get(), key);
+    if (!is_first)
+    {
+      auto on_landed = [this, process, continuation](const FlightResult& result) {
+        if (result.has_value())
+        {
+          continuation(serveFromFlightResult(result.value()));
+        }
+        else
+        {
+          process(); // the first request failed
+        }
+      };
+      std::unique_lock lock(joined_flight->mutex);
+      if (!joined_flight->result.has_value())
+      {
+        joined_flight->waiters.push_back(std::move(on_landed));
+        return;
+      }
+      lock.unlock();
+      on_landed(joined_flight->result.value());
+      return;
+    }
+    flight = joined_flight;
+  }
+  if (flight == nullptr)
+  {
+    process();
+    return;
+  }
+
+  try
+  {
+    func(context, [this, key, flight, continuation, load_start_time = Cache::Clock::now()](Status status) {
+      recordLoadTime(load_start_time);
+      Cache::Element result;
+      try
+      {
+        result = writeToCache(key, status);
+      }
+      catch (...)
+      {
+        landFlight(_parameters.cache.get(), key, flight, std::nullopt);
+        throw;
+      }
+      landFlight(_parameters.cache.get(), key, flight, std::move(result));
+      continuation(status);
+    });
+  }
+  catch (...)
+  {
+    landFlight(_parameters.cache.get(), key, flight, std::nullopt); // no-op if the continuation has already landed it
+    throw;
+  }
+}
+
+std::optional<Status> CachingRequestHook::readFromCache(const std::string& key, std::shared_ptr<Flight>& flight) const
+{
+  std::shared_ptr<const Cache::Element> element = _parameters.cache->GetShared(key);
+  if (element == nullptr)
+  {
+    if (_parameters.statistics != nullptr)
+    {
+      _parameters.statistics->RecordMiss();
+    }
+    return std::nullopt;
+  }
+
+  const Lifetime lifetime = getLifetime(_parameters, element->status.code);
+  const auto age = Cache::Clock::now() - element->insertion_time;
+  if (age > lifetime.max_age + lifetime.stale_duration)
+  {
+    // cache expired
+    _parameters.cache->Remove(key);
+    if (_parameters.statistics != nullptr)
+    {
+      _parameters.statistics->RecordExpiration();
+      _parameters.statistics->RecordMiss();
+    }
+    return std::nullopt;
+  }
+  if (age > lifetime.max_age * lifetime.refresh_ahead_fraction)
+  {
+    // stale or due for a refresh, unless another request refreshes it already
+    if (auto [refresh_flight, is_first] = joinFlight(_parameters.cache.get(), key); is_first)
+    {
+      if (_parameters.refresher == nullptr)
+      {
+        flight = refresh_flight;
+        if (_parameters.statistics != nullptr)
+        {
+          _parameters.statistics->RecordMiss(); // as the function is executed
+        }
+        return std::nullopt;
+      }
+      _parameters.refresh_executor->Post(
+          [parameters = _parameters, key, tags = element->tags, refresh_flight = refresh_flight]() {
+            refreshInBackground(parameters, key, tags, refresh_flight);
+          });
+    }
+  }
+
+  // cache hit
+  _parameters.cache_reader(element->data);
+  if (_parameters.statistics != nullptr)
+  {
+    _parameters.statistics->RecordHit();
+  }
+  return element->status;
+}
+
+Cache::Element CachingRequestHook::writeToCache(const std::string& key, const Status& status) const
+{
+  if (_parameters.status_codes_to_cache.find(status.code) == _parameters.status_codes_to_cache.end())
+  {
+    return Cache::Element{std::any(), status, Cache::Clock::now()};
+  }
+  const Cache::TimePoint now = Cache::Clock::now();
+  Cache::Element element{_parameters.cache_writer(), status, now,
+                         getExpiryTime(now, getLifetime(_parameters, status.code))};
+  element.weight = _parameters.weigher(element.data);
+  if (_parameters.tag_generator)
+  {
+    element.tags = _parameters.tag_generator();
+  }
+  _parameters.cache->Insert(key, element);
+  return element;
+}
+
+std::optional<Status> CachingRequestHook::waitForFlight(Flight& flight) const
+{
+  std::unique_lock lock(flight.mutex);
+  if (!flight.landed.wait_for(lock, _parameters.coalescing_wait_timeout,
+                              [&flight]() { return flight.result.has_value(); }) ||
+      !flight.result->has_value())
+  {
+    return std::nullopt; // timed out or the first request failed
+  }
+  lock.unlock(); // the result does not change after landing
+  return serveFromFlightResult(flight.result->value());
+}
+
+void CachingRequestHook::recordLoadTime(const Cache::TimePoint& load_start_time) const
+{
+  if (_parameters.statistics != nullptr)
+  {
+    _parameters.statistics->RecordLoadTime(Cache::Clock::now() - load_start_time);
+  }
+}
+
+Status CachingRequestHook::serveFromFlightResult(const Cache::Element& result) const
+{
+  if (Cache::IsValid(result))
+  {
+    _parameters.cache_reader(result.data);
+  }
+  return result.status;
+}
+
+std::pair<std::shared_ptr<CachingRequestHook::Flight>, bool> CachingRequestHook::joinFlight(const Cache* cache,
+                                                                                           const std::string& key)
+{
+  Flight::Registry& registry = Flight::GetRegistry();
+  std::lock_guard lock(registry.mutex);
+  auto [it, inserted] = registry.flights.try_emplace({cache, key});
+  if (inserted)
+  {
+    it->second = std::make_shared<Flight>();
+  }
+  return {it->second, inserted};
+}
+
+void CachingRequestHook::landFlight(const Cache* cache, const std::string& key, const std::shared_ptr<Flight>& flight,
+                                    FlightResult result)
+{
+  {
+    Flight::Registry& registry = Flight::GetRegistry();
+    std::lock_guard lock(registry.mutex);
+    if (auto it = registry.flights.find({cache, key}); it != registry.flights.end() && it->second == flight)
+    {
+      registry.flights.erase(it);
+    }
+  }
+
+  std::vector<std::function<void(const FlightResult&)>> waiters;
+  {
+    std::lock_guard lock(flight->mutex);
+    if (flight->result.has_value())
+    {
+      return; // already landed
+    }
+    flight->result = std::move(result);
+    waiters.swap(flight->waiters);
+  }
+  flight->landed.notify_all();
+  for (const auto& waiter : waiters)
+  {
+    waiter(flight->result.value());
+  }
+}
+
+void CachingRequestHook::refreshInBackground(const Parameters& parameters, const std::string& key,
+                                             const std::vector<std::string>& tags,
+                                             const std::shared_ptr<Flight>& flight)
+{
+  Cache::Element result;
+  try
+  {
+    result.status = parameters.refresher(result.data);
+    result.insertion_time = Cache::Clock::now();
+    result.expiry_time = getExpiryTime(result.insertion_time, getLifetime(parameters, result.status.code));
+    if (parameters.status_codes_to_cache.find(result.status.code) != parameters.status_codes_to_cache.end())
+    {
+      result.weight = parameters.weigher(result.data);
+      result.tags = tags;
+      parameters.cache->Insert(key, result);
+    }
+    else
+    {
+      result.data.reset(); // the stale element is kept
+    }
+  }
+  catch (const std::exception& e)
+  {
+    // the stale element is kept and the next request after it has expired executes the function
+    MSE_LOG_ERROR(std::string("background refresh of cache key '") + key + "' failed with exception: " + e.what());
+    landFlight(parameters.cache.get(), key, flight, std::nullopt);
+    return;
+  }
+  catch (...)
+  {
+    MSE_LOG_ERROR(std::string("background refresh of cache key '") + key + "' failed with unknown exception");
+    landFlight(parameters.cache.get(), key, flight, std::nullopt);
+    return;
+  }
+  landFlight(parameters.cache.get(), key, flight, std::move(result));
+}
+
+UnorderedMapCache::UnorderedMapCache(std::size_t shard_count, const Duration& expiry_resolution)
+{
+  std::size_t power_of_two_shard_count = 1;
+  while (power_of_two_shard_count < shard_count)
+  {
+    power_of_two_shard_count <<= 1;
+  }
+  _shard_mask = power_of_two_shard_count - 1;
+  _shards = std::make_unique<Shard[]>(power_of_two_shard_count);
+  const TimePoint start_time = Clock::now();
+  for (std::size_t i = 0; i < power_of_two_shard_count; ++i)
+  {
+    _shards[i].expiry_times = TimingWheel(expiry_resolution, start_time);
+  }
+}
+
+UnorderedMapCache::~UnorderedMapCache()
+{
+  {
+    std::lock_guard lock(_reclamation_mutex);
+    _stop_reclamation = true;
+  }
+  _reclamation_condition.notify_all();
+  if (_reclamation_thread.joinable())
+  {
+    _reclamation_thread.join();
+  }
+}
+
 void UnorderedMapCache::Insert(const std::string& key, const Element& element)
 {
-  std::unique_lock lock(_mutex);
-  _data[key] = element;
+  std::shared_ptr<const Element> shared_element = std::make_shared<const Element>(element);
+  std::shared_ptr<const Element> replaced_element;                // released after the lock
+  std::vector<std::shared_ptr<const Element>> reclaimed_elements; // released after the lock
+  Shard& shard = getShard(key);
+  std::unique_lock lock(shard.mutex);
+  replaced_element = std::exchange(shard.data[key], std::move(shared_element));
+  if (element.expiry_time != TimePoint::max())
+  {
+    shard.expiry_times.Schedule(key, element.expiry_time);
+  }
+  reclaimExpired(shard, Clock::now(), reclaimed_elements);
+  if (_statistics != nullptr)
+  {
+    _statistics->RecordInsert();
+    _statistics->AddToSize(replaced_element == nullptr ? 1 : 0);
+  }
 }
 
 Cache::Element UnorderedMapCache::Get(const std::string& key) const
 {
-  std::shared_lock lock(_mutex);
-  if (const auto& cit = _data.find(key); cit != _data.end())
+  if (std::shared_ptr<const Element> element = GetShared(key); element != nullptr)
   {
-    return cit->second;
+    return *element;
   }
   return InvalidElement;
 }
 
 void UnorderedMapCache::Remove(const std::string& key)
 {
-  std::unique_lock lock(_mutex);
-  _data.erase(key);
+  std::shared_ptr<const Element> removed_element; // released after the lock
+  Shard& shard = getShard(key);
+  std::unique_lock lock(shard.mutex);
+  if (auto it = shard.data.find(key); it != shard.data.end())
+  {
+    removed_element = std::move(it->second);
+    shard.data.erase(it); // its expiry time stays in the timing wheel and is ignored when it is reported
+    if (_statistics != nullptr)
+    {
+      _statistics->AddToSize(-1);
+    }
+  }
+}
+
+std::shared_ptr<const Cache::Element> UnorderedMapCache::GetShared(const std::string& key) const
+{
+  const Shard& shard = getShard(key);
+  std::shared_lock lock(shard.mutex);
+  if (const auto& cit = shard.data.find(key); cit != shard.data.end() && !isExpired(*cit->second, Clock::now()))
+  {
+    if (_statistics != nullptr)
+    {
+      _statistics->RecordHit();
+    }
+    return cit->second;
+  }
+  if (_statistics != nullptr)
+  {
+    _statistics->RecordMiss();
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const Cache::Element> UnorderedMapCache::Peek(const std::string& key) const
+{
+  const Shard& shard = getShard(key);
+  std::shared_lock lock(shard.mutex);
+  if (const auto& cit = shard.data.find(key); cit != shard.data.end() && !isExpired(*cit->second, Clock::now()))
+  {
+    return cit->second;
+  }
+  return nullptr;
+}
+
+void UnorderedMapCache::ReclaimExpired()
+{
+  const TimePoint now = Clock::now();
+  for (std::size_t i = 0; i <= _shard_mask; ++i)
+  {
+    std::vector<std::shared_ptr<const Element>> reclaimed_elements; // released after the lock
+    std::unique_lock lock(_shards[i].mutex);
+    reclaimExpired(_shards[i], now, reclaimed_elements);
+  }
+}
+
+void UnorderedMapCache::StartBackgroundReclamation(const Duration& interval)
+{
+  std::lock_guard lock(_reclamation_mutex);
+  if (_reclamation_thread.joinable())
+  {
+    throw std::logic_error("background reclamation has already been started");
+  }
+  _reclamation_thread = std::thread([this, interval]() {
+    std::unique_lock lock(_reclamation_mutex);
+    while (!_reclamation_condition.wait_for(lock, interval, [this]() { return _stop_reclamation; }))
+    {
+      lock.unlock();
+      ReclaimExpired();
+      lock.lock();
+    }
+  });
+}
+
+std::vector<std::shared_ptr<const Cache::Element>>
+UnorderedMapCache::GetMany(const std::vector<std::string>& keys) const
+{
+  std::vector<std::size_t> shard_indices;
+  shard_indices.reserve(keys.size());
+  for (const std::string& key : keys)
+  {
+    shard_indices.push_back(getShardIndex(key));
+  }
+
+  std::vector<std::shared_ptr<const Element>> elements(keys.size());
+  std::size_t hit_count = 0;
+  const TimePoint now = Clock::now();
+  const std::vector<std::size_t> positions = orderByShard(shard_indices);
+  for (auto it = positions.begin(); it != positions.end();)
+  {
+    const Shard& shard = _shards[shard_indices[*it]];
+    std::shared_lock lock(shard.mutex);
+    for (; it != positions.end() && &_shards[shard_indices[*it]] == &shard; ++it)
+    {
+      if (const auto& cit = shard.data.find(keys[*it]); cit != shard.data.end() && !isExpired(*cit->second, now))
+      {
+        elements[*it] = cit->second;
+        ++hit_count;
+      }
+    }
+  }
+  if (_statistics != nullptr)
+  {
+    _statistics->RecordHit(hit_count);
+    _statistics->RecordMiss(keys.size() - hit_count);
+  }
+  return elements;
+}
+
+void UnorderedMapCache::InsertMany(const std::vector<std::pair<std::string, Element>>& elements)
+{
+  std::vector<std::size_t> shard_indices;
+  std::vector<std::shared_ptr<const Element>> shared_elements;
+  shard_indices.reserve(elements.size());
+  shared_elements.reserve(elements.size());
+  for (const auto& [key, element] : elements)
+  {
+    shard_indices.push_back(getShardIndex(key));
+    shared_elements.push_back(std::make_shared<const Element>(element));
+  }
+
+  std::vector<std::shared_ptr<const Element>> replaced_elements;  // released after the locks
+  std::vector<std::shared_ptr<const Element>> reclaimed_elements; // released after the locks
+  replaced_elements.reserve(elements.size());
+  std::int64_t added_count = 0;
+  const TimePoint now = Clock::now();
+  const std::vector<std::size_t> positions = orderByShard(shard_indices);
+  for (auto it = positions.begin(); it != positions.end();)
+  {
+    Shard& shard = _shards[shard_indices[*it]];
+    std::unique_lock lock(shard.mutex);
+    for (; it != positions.end() && &_shards[shard_indices[*it]] == &shard; ++it)
+    {
+      const auto& [key, element] = elements[*it];
+      replaced_elements.push_back(std::exchange(shard.data[key], std::move(shared_elements[*it])));
+      added_count += replaced_elements.back() == nullptr ? 1 : 0;
+      if (element.expiry_time != TimePoint::max())
+      {
+        shard.expiry_times.Schedule(key, element.expiry_time);
+      }
+    }
+    reclaimExpired(shard, now, reclaimed_elements);
+  }
+  if (_statistics != nullptr)
+  {
+    _statistics->RecordInsert(elements.size());
+    _statistics->AddToSize(added_count);
+  }
+}
+
+UnorderedMapCache::Shard& UnorderedMapCache::getShard(const std::string& key) const
+{
+  return _shards[getShardIndex(key)];
+}
+
+std::size_t UnorderedMapCache::getShardIndex(const std::string& key) const
+{
+  return std::hash<std::string>{}(key) & _shard_mask;
+}
+
+void UnorderedMapCache::reclaimExpired(Shard& shard, const TimePoint& now,
+                                       std::vector<std::shared_ptr<const Element>>& reclaimed_elements)
+{
+  const std::size_t previously_reclaimed_count = reclaimed_elements.size(); // e.g. from other shards
+  shard.expiry_times.Advance(now, [&shard, &now, &reclaimed_elements](const std::string& key) {
+    // the element might have been removed or replaced with a later expiry time in the meantime
+    if (auto it = shard.data.find(key); it != shard.data.end() && isExpired(*it->second, now))
+    {
+      reclaimed_elements.push_back(std::move(it->second));
+      shard.data.erase(it);
+    }
+  });
+  if (_statistics != nullptr)
+  {
+    const std::size_t reclaimed_count = reclaimed_elements.size() - previously_reclaimed_count;
+    _statistics->RecordExpiration(reclaimed_count);
+    _statistics->AddToSize(-static_cast<std::int64_t>(reclaimed_count));
+  }
+}
+
+bool UnorderedMapCache::isExpired(const Element& element, const TimePoint& now)
+{
+  return element.expiry_time != TimePoint::max() && element.expiry_time <= now;
 }
 
 LRUCache::LRUCache(std::shared_ptr<Cache> realCache, std::size_t maxSize) : _realCache(realCache), _maxSize(maxSize)
@@ -169,37 +943,77 @@ void LRUCache::Insert(const std::string& key, const Element& element)
 
   std::unique_lock lock(_mutex);
 
-  // 1. ensure that there is enought space in the cache
+  // 1. a replaced key keeps a single position in the LRU order
+  if (auto it = _positions.find(key); it != _positions.end())
+  {
+    remove(it->second);
+  }
+
+  // 2. ensure that there is enought space in the cache
   while (_lru.size() >= _maxSize)
   {
     _realCache->Remove(_lru.back());
-    _lru.pop_back();
+    remove(std::prev(_lru.end()));
+    if (_statistics != nullptr)
+    {
+      _statistics->RecordEviction();
+    }
   }
 
-  // 2. insert element into the cache
+  // 3. insert element into the cache
   _lru.push_front(key);
-  _realCache->Insert(key, Element{LRUElement{_lru.begin(), element.data}, element.status, element.insertion_time});
+  _positions[key] = _lru.begin();
+  _realCache->Insert(key, element);
+  if (_statistics != nullptr)
+  {
+    _statistics->RecordInsert();
+    _statistics->AddToSize(1);
+  }
 }
 
 Cache::Element LRUCache::Get(const std::string& key) const
+{
+  if (std::shared_ptr<const Element> element = GetShared(key); element != nullptr)
+  {
+    return *element;
+  }
+  return InvalidElement;
+}
+
+std::shared_ptr<const Cache::Element> LRUCache::GetShared(const std::string& key) const
 {
   if (_realCache == nullptr)
   {
-    return Cache::InvalidElement;
+    return nullptr;
   }
 
   // 1. move element to the very front of the list
   std::unique_lock lock(_mutex);
-  Cache::Element element = _realCache->Get(key);
-  if (!Cache::IsValid(element))
+  std::shared_ptr<const Element> element = _realCache->GetShared(key);
+  const auto it = _positions.find(key);
+  if (element == nullptr)
   {
-    return Cache::InvalidElement;
+    if (it != _positions.end())
+    {
+      remove(it->second); // e.g. expired and reclaimed by the real cache
+    }
+    if (_statistics != nullptr)
+    {
+      _statistics->RecordMiss();
+    }
+    return nullptr;
+  }
+  if (it != _positions.end())
+  {
+    _lru.splice(_lru.begin(), _lru, it->second);
+  }
+  if (_statistics != nullptr)
+  {
+    _statistics->RecordHit();
   }
-  LRUElement lruElement = std::any_cast<LRUElement>(element.data);
-  _lru.splice(_lru.begin(), _lru, lruElement.first);
 
-  // 2. return element
-  return Element{lruElement.second, element.status, element.insertion_time};
+  // 2. return the element as shared by the real cache, i.e. without copying it
+  return element;
 }
 
 void LRUCache::Remove(const std::string& key)
@@ -209,14 +1023,38 @@ void LRUCache::Remove(const std::string& key)
     return;
   }
   std::unique_lock lock(_mutex);
-  mse::Cache::Element element = _realCache->Get(key);
-  if (!mse::Cache::IsValid(element))
+  if (auto it = _positions.find(key); it != _positions.end())
   {
-    return;
+    remove(it->second); // also if the real cache has dropped the element already
+  }
+  _realCache->Remove(key);
+}
+
+std::shared_ptr<const Cache::Element> LRUCache::Peek(const std::string& key) const
+{
+  if (_realCache == nullptr)
+  {
+    return nullptr;
   }
-  if (auto it = std::any_cast<LRUElement>(element.data).first; it != _lru.end())
+  return _realCache->Peek(key); // keeps the LRU order
+}
+
+void LRUCache::remove(std::list<std::string>::iterator it) const
+{
+  _positions.erase(*it);
+  _lru.erase(it);
+  if (_statistics != nullptr)
   {
-    _lru.erase(it);
+    _statistics->AddToSize(-1);
   }
-  _realCache->Remove(key);
+}
+
+Cache::TimePoint impl::getExpiryTime(const Cache::TimePoint& insertion_time,
+                                     const CachingRequestHook::Parameters::Duration& usable_duration)
+{
+  if (usable_duration >= Cache::TimePoint::max() - insertion_time) // e.g. NeverExpire
+  {
+    return Cache::TimePoint::max();
+  }
+  return insertion_time + std::chrono::duration_cast<Cache::Clock::duration>(usable_duration);
 }
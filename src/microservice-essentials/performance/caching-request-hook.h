@@ -2,19 +2,38 @@
 
 #include <any>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <list>
 #include <memory>
+#include <microservice-essentials/performance/cache-statistics.h>
+#include <microservice-essentials/performance/timing-wheel.h>
 #include <microservice-essentials/request/request-hook-factory.h>
 #include <microservice-essentials/request/request-hook.h>
+#include <microservice-essentials/utilities/executor.h>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace mse
 {
 
 /**
  * Cache interface with insert, get and remove operations.
+ * GetShared returns the element with shared ownership instead of a copy. Its default implementation copies the element
+ * returned by Get, caches that store their elements with shared ownership (e.g. UnorderedMapCache) avoid that copy.
+ * Peek returns the element like GetShared, but without side effects such as recording statistics or updating the
+ * recency or frequency of the element, so that decorators can inspect the real cache (e.g. PersistentCache). Its
+ * default implementation calls GetShared, caches whose reads have side effects override it.
+ * Caches that support expiry times per element (e.g. UnorderedMapCache) treat expired elements as non-existent.
+ * Caches that support statistics (e.g. UnorderedMapCache, LRUCache) record them if statistics have been set.
+ * GetMany and InsertMany process batches of elements. Their default implementations call GetShared and Insert per
+ * element, caches with locks (e.g. UnorderedMapCache) take each lock once per batch instead of once per element.
  */
 class Cache
 {
@@ -26,6 +45,9 @@ public:
     std::any data;
     Status status;
     TimePoint insertion_time;
+    TimePoint expiry_time = TimePoint::max();
+    std::size_t weight = 1;             // e.g. the size in bytes, see WeightedLRUCache
+    std::vector<std::string> tags = {}; // see TaggedCache
   };
   static const Element InvalidElement;
   static bool IsValid(const Element& element);
@@ -35,14 +57,38 @@ public:
   virtual void Insert(const std::string& key, const Element& element) = 0;
   virtual Element Get(const std::string& key) const = 0;
   virtual void Remove(const std::string& key) = 0;
+
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const; // nullptr if there is no element
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const;      // nullptr if there is no element
+
+  // returns the elements in the order of the keys, nullptr for keys without an element
+  virtual std::vector<std::shared_ptr<const Element>> GetMany(const std::vector<std::string>& keys) const;
+  virtual void InsertMany(const std::vector<std::pair<std::string, Element>>& elements);
+
+  void SetStatistics(std::shared_ptr<CacheStatistics> statistics); // shall be set before the cache is used
+  std::shared_ptr<CacheStatistics> GetStatistics() const;
+
+protected:
+  std::shared_ptr<CacheStatistics> _statistics; // nullptr if no statistics are recorded
 };
 
-using CacheKeyGen = std::function<std::string()>;         // generates a key for the request
-using CacheReader = std::function<void(const std::any&)>; // restores the object from the cache
-using CacheWriter = std::function<std::any()>;            // returns the data to be cached
+using CacheKeyGen = std::function<std::string()>;                 // generates a key for the request
+using CacheKeyWriter = std::function<void(std::string&)>;         // appends the key for the request to an empty buffer
+using CacheReader = std::function<void(const std::any&)>;         // restores the object from the cache
+using CacheWriter = std::function<std::any()>;                    // returns the data to be cached
+using CacheRefresher = std::function<Status(std::any&)>;          // recomputes the data to be cached without a request
+using CacheWeigher = std::function<std::size_t(const std::any&)>; // returns the weight of the data to be cached
+using CacheTagGen = std::function<std::vector<std::string>()>;    // generates the tags of the data to be cached
 
 /**
  * Request hook that returns immediately if the requested resource is already in the cache.
+ * With request coalescing enabled, only the first of concurrent cache misses for the same cache and key executes the
+ * function. The other requests wait for its result and are served from it, including its status code. If the waiting
+ * times out or the first request fails with an exception, a waiting request executes the function on its own.
+ * Elements that are stale (see WithStaleWhileRevalidate) or due for a refresh (see WithRefreshAhead) are still served,
+ * while a single request per key refreshes them. With a background refresher, the refresh runs on an executor, so that
+ * no request has to wait for it. Otherwise, the request that triggers the refresh executes the function instead of
+ * being served from the cache.
  */
 class CachingRequestHook : public mse::RequestHook
 {
@@ -55,16 +101,47 @@ public:
 
     Parameters& WithConstantResponse();
     Parameters& WithKeyGenerator(const CacheKeyGen& key_generator_);
+    // the key buffers are reused per thread, so writing keys does not allocate once the buffers have grown
+    Parameters& WithKeyWriter(const CacheKeyWriter& key_writer_);
     Parameters& WithKey(const std::string& key_);
     template <typename T>
     Parameters& WithStdToStringKeyGenerator(const T& object); // uses std::to_string<T> to generate the key
+    // composes the key from the parts joined by '/', e.g. WithKeyFrom("starship", id) generates "starship/42"
+    // '/' and backslashes in string and character parts are escaped by a backslash, so that parts never collide
+    // strings and integers are appended without allocating, lvalues are referenced so that they may change per request
+    template <typename... T> Parameters& WithKeyFrom(T&&... parts);
 
     Parameters& WithCacheReader(CacheReader reader_);
     Parameters& WithCacheWriter(CacheWriter writer_);
     template <typename T> Parameters& WithCachedObject(T& o); // sets writer and reader to store and restore the object
+    // stores and restores the handle only, so that cache hits share the object instead of copying it
+    template <typename T> Parameters& WithCachedObject(std::shared_ptr<const T>& o);
 
     Parameters& WithMaxAge(const Duration& max_age_);
     Parameters& NeverExpire(); // same as WithMaxAge(std::chrono::duration<double>::max())
+    // includes the status codes and overrides their max age, e.g. to cache errors briefly in front of a failing service
+    // only the max age is overridden for StatusCode::ok. Elements with other status codes are neither served stale nor
+    // refreshed ahead, so that errors never outlive their max age
+    Parameters& WithMaxAge(const StatusCode& status_code_, const Duration& max_age_);
+    Parameters& WithMaxAge(const std::initializer_list<StatusCode>& status_codes_, const Duration& max_age_);
+
+    // waiting is not limited by the timeout for asynchronously processed requests
+    Parameters& WithRequestCoalescing(const Duration& wait_timeout_ = std::chrono::seconds(10));
+
+    Parameters& WithStaleWhileRevalidate(const Duration& stale_duration_); // serves expired elements for that long
+    Parameters& WithRefreshAhead(double fraction_); // refreshes hits that are older than fraction * max age
+    // the refresher has to produce the same data as the cache writer. It runs on the executor, which must not be null.
+    // if it throws, the stale element is kept
+    Parameters& WithBackgroundRefresh(CacheRefresher refresher_, std::shared_ptr<Executor> executor_);
+
+    Parameters& WithWeigher(CacheWeigher weigher_);
+    // attaches tags to the cached elements, so that they can be invalidated together (see TaggedCache)
+    Parameters& WithTags(const std::vector<std::string>& tags_);
+    // called after the request has been processed, so the tags may depend on the response
+    Parameters& WithTagGenerator(const CacheTagGen& tag_generator_);
+    Parameters& WithStatistics(std::shared_ptr<CacheStatistics> statistics_); // records hits, misses and load times
+    // the size of std::string data (also if shared, see WithCachedObject), 1 otherwise
+    static std::size_t DefaultWeigher(const std::any& data);
 
     Parameters& IncludeAllStatusCodes();
     Parameters& Include(const StatusCode& status_code_);
@@ -73,45 +150,116 @@ public:
     Parameters& Exclude(const std::initializer_list<StatusCode>& status_codes_);
 
     std::shared_ptr<Cache> cache;
-    CacheKeyGen key_generator;
+    CacheKeyGen key_generator; // used if no key writer is set
+    CacheKeyWriter key_writer;
     CacheReader cache_reader;
     CacheWriter cache_writer;
     Duration max_age = std::chrono::minutes(10);
     std::unordered_set<StatusCode> status_codes_to_cache = {StatusCode::ok};
+    std::unordered_map<StatusCode, Duration> status_code_max_ages;
+    bool coalesce_requests = false;
+    Duration coalescing_wait_timeout = std::chrono::seconds(10);
+    Duration stale_duration = Duration::zero();
+    double refresh_ahead_fraction = 1.0;
+    CacheRefresher refresher;
+    std::shared_ptr<Executor> refresh_executor;
+    CacheWeigher weigher = DefaultWeigher;
+    CacheTagGen tag_generator;
+    std::shared_ptr<CacheStatistics> statistics;
 
     AutoRequestHookParameterRegistration<CachingRequestHook::Parameters, CachingRequestHook> auto_registration;
   };
 
-  CachingRequestHook(const Parameters& parameters);
+  CachingRequestHook(const Parameters& parameters); // throws std::invalid_argument for a refresher without executor
   virtual ~CachingRequestHook();
 
   virtual Status Process(Func func, Context& context) override;
+  virtual void ProcessAsync(AsyncFunc func, Context& context, Continuation continuation) override;
 
 protected:
 private:
+  struct Flight; // a request for a key that is currently being processed, see request coalescing
+  using FlightResult = std::optional<Cache::Element>; // nullopt if processing failed with an exception
+
+  // returns the cached status in case of a cache hit, sets the flight if the caller has to refresh the element
+  std::optional<Status> readFromCache(const std::string& key, std::shared_ptr<Flight>& flight) const;
+  // returns the result to be shared with coalesced requests
+  Cache::Element writeToCache(const std::string& key, const Status& status) const;
+  // returns nullopt if the caller has to process the request on its own
+  std::optional<Status> waitForFlight(Flight& flight) const;
+  Status serveFromFlightResult(const Cache::Element& result) const;
+  void recordLoadTime(const Cache::TimePoint& load_start_time) const;
+
+  // returns the flight for the key and whether the caller has started it and therefore has to land it
+  static std::pair<std::shared_ptr<Flight>, bool> joinFlight(const Cache* cache, const std::string& key);
+  static void landFlight(const Cache* cache, const std::string& key, const std::shared_ptr<Flight>& flight,
+                         FlightResult result);
+  // the refreshed element keeps the tags of the stale one
+  static void refreshInBackground(const Parameters& parameters, const std::string& key,
+                                  const std::vector<std::string>& tags, const std::shared_ptr<Flight>& flight);
+
   Parameters _parameters;
 };
 
 /**
- * Cache implementation based on a std::unordered_map.
+ * Cache implementation based on std::unordered_maps.
+ * The keys are distributed by their hash over a power of two number of shards, each guarded by its own lock, so that
+ * concurrent requests for different keys rarely contend. Elements are stored with shared ownership, so GetShared never
+ * copies the cached data.
+ * The expiry times of the elements are tracked with a timing wheel per shard. Expired elements are reclaimed
+ * incrementally on insertion into their shard, by ReclaimExpired or by a background thread (see
+ * StartBackgroundReclamation), without scanning the shards.
  */
 class UnorderedMapCache : public Cache
 {
 public:
-  UnorderedMapCache() = default;
-  virtual ~UnorderedMapCache() = default;
+  using Duration = TimingWheel::Duration;
+
+  // shard_count is rounded up to the next power of two, expiry times are reclaimed at most expiry_resolution late
+  UnorderedMapCache(std::size_t shard_count = 16, const Duration& expiry_resolution = std::chrono::seconds(1));
+  virtual ~UnorderedMapCache();
 
   virtual void Insert(const std::string& key, const Element& element) override;
   virtual Element Get(const std::string& key) const override;
   virtual void Remove(const std::string& key) override;
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
+  virtual std::vector<std::shared_ptr<const Element>> GetMany(const std::vector<std::string>& keys) const override;
+  virtual void InsertMany(const std::vector<std::pair<std::string, Element>>& elements) override;
+
+  void ReclaimExpired();
+  void StartBackgroundReclamation(const Duration& interval); // calls ReclaimExpired periodically until destruction
 
 private:
-  mutable std::shared_mutex _mutex;
-  std::unordered_map<std::string, Element> _data;
+  struct alignas(64) Shard // aligned to a cache line, so that the locks of different shards do not share cache lines
+  {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<const Element>> data;
+    TimingWheel expiry_times;
+  };
+
+  Shard& getShard(const std::string& key) const;
+  std::size_t getShardIndex(const std::string& key) const;
+  // requires the shard's lock, the reclaimed elements are appended to the given vector to be released after the lock
+  void reclaimExpired(Shard& shard, const TimePoint& now,
+                      std::vector<std::shared_ptr<const Element>>& reclaimed_elements);
+  static bool isExpired(const Element& element, const TimePoint& now);
+
+  std::size_t _shard_mask;
+  std::unique_ptr<Shard[]> _shards;
+
+  std::mutex _reclamation_mutex;
+  std::condition_variable _reclamation_condition;
+  bool _stop_reclamation = false;
+  std::thread _reclamation_thread;
 };
 
 /**
  * Cache decorator that implements a Least Recently Used (LRU) cache.
+ * Keys whose elements the real cache has dropped on its own (e.g. expired) are removed from the LRU order as soon as
+ * they are missed, so they neither count against the maximum size nor cause an eviction of a newer element.
+ * GetShared passes on the elements shared by the real cache, so hits do not copy them if the real cache stores its
+ * elements with shared ownership (e.g. UnorderedMapCache).
  */
 class LRUCache : public Cache
 {
@@ -122,15 +270,28 @@ public:
   virtual void Insert(const std::string& key, const Element& element) override;
   virtual Element Get(const std::string& key) const override;
   virtual void Remove(const std::string& key) override;
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
 
 private:
-  typedef std::pair<std::list<std::string>::iterator, std::any> LRUElement;
+  void remove(std::list<std::string>::iterator it) const; // removes the key from the LRU order only
+
   std::shared_ptr<Cache> _realCache;
   mutable std::shared_mutex _mutex;
-  mutable std::list<std::string> _lru;
+  mutable std::list<std::string> _lru; // most recently used first
+  mutable std::unordered_map<std::string, std::list<std::string>::iterator> _positions;
   std::size_t _maxSize = 1000;
 };
 
+namespace impl
+{
+// appends strings, characters (escaping '/' and backslashes) and numbers to a cache key (to be used internally only)
+template <typename T> void appendToCacheKey(std::string& key, const T& part);
+// returns TimePoint::max() if the duration does not fit, e.g. for NeverExpire (to be used internally only)
+Cache::TimePoint getExpiryTime(const Cache::TimePoint& insertion_time,
+                               const CachingRequestHook::Parameters::Duration& usable_duration);
+} // namespace impl
+
 } // namespace mse
 
 #include <microservice-essentials/performance/caching-request-hook.txx>
@@ -1,20 +1,95 @@
+#include <charconv>
 #include <microservice-essentials/performance/caching-request-hook.h>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace mse
 {
 
 template <typename T> CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithCachedObject(T& object)
 {
-  cache_reader = [&object](const std::any& data) { object = std::any_cast<T>(data); };
+  cache_reader = [&object](const std::any& data) { object = std::any_cast<const T&>(data); };
   cache_writer = [&object]() -> std::any { return T(object); };
   return *this;
 }
 
+template <typename T>
+CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithCachedObject(std::shared_ptr<const T>& object)
+{
+  cache_reader = [&object](const std::any& data) { object = std::any_cast<const std::shared_ptr<const T>&>(data); };
+  cache_writer = [&object]() -> std::any { return object; };
+  return *this;
+}
+
 template <typename T>
 CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithStdToStringKeyGenerator(const T& object)
 {
-  key_generator = [&object]() -> std::string { return std::to_string(object); };
+  key_generator = nullptr;
+  key_writer = [&object](std::string& key) { key.append(std::to_string(object)); };
+  return *this;
+}
+
+template <typename... T> CachingRequestHook::Parameters& CachingRequestHook::Parameters::WithKeyFrom(T&&... parts)
+{
+  // T is a reference for lvalues, so the tuple references them and copies rvalues
+  key_generator = nullptr;
+  key_writer = [stored_parts = std::tuple<T...>(std::forward<T>(parts)...)](std::string& key) {
+    std::apply(
+        [&key](const auto&... parts) {
+          bool is_first_part = true;
+          auto append = [&key, &is_first_part](const auto& part) {
+            if (!is_first_part)
+            {
+              key.push_back('/');
+            }
+            is_first_part = false;
+            impl::appendToCacheKey(key, part);
+          };
+          (append(parts), ...);
+        },
+        stored_parts);
+  };
   return *this;
 }
 
+template <typename T> void impl::appendToCacheKey(std::string& key, const T& part)
+{
+  if constexpr (std::is_same_v<T, bool>)
+  {
+    key.append(part ? "true" : "false");
+  }
+  else if constexpr (std::is_same_v<T, char>)
+  {
+    if (part == '/' || part == '\\')
+    {
+      key.push_back('\\');
+    }
+    key.push_back(part);
+  }
+  else if constexpr (std::is_integral_v<T>)
+  {
+    char buffer[24]; // enough for all 64 bit integers
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), part);
+    key.append(buffer, result.ptr);
+  }
+  else if constexpr (std::is_arithmetic_v<T>)
+  {
+    key.append(std::to_string(part));
+  }
+  else
+  {
+    const std::string_view text(part);
+    std::size_t start = 0;
+    for (std::size_t pos = text.find_first_of("/\\"); pos != std::string_view::npos;
+         pos = text.find_first_of("/\\", pos + 1))
+    {
+      key.append(text, start, pos - start).push_back('\\');
+      start = pos;
+    }
+    key.append(text, start);
+  }
+}
+
 } // namespace mse
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "clock-cache.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <utility>
+
+using namespace mse;
+
+namespace
+{
+bool isExpired(const Cache::Element& element, const Cache::TimePoint& now)
+{
+  return element.expiry_time != Cache::TimePoint::max() && element.expiry_time <= now;
+}
+
+std::size_t getThreadIndex()
+{
+  static std::atomic<std::size_t> next_thread_index = 0;
+  thread_local const std::size_t thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+  return thread_index;
+}
+
+std::size_t roundUpToPowerOfTwo(std::size_t value)
+{
+  std::size_t power_of_two = 1;
+  while (power_of_two < value)
+  {
+    power_of_two <<= 1;
+  }
+  return power_of_two;
+}
+} // namespace
+
+ClockCache::ReadGuard::ReadGuard(const ClockCache& cache)
+{
+  ReaderStripe& stripe = cache._reader_stripes[getThreadIndex() % ReaderStripeCount];
+  for (;;)
+  {
+    const std::uint64_t epoch = cache._epoch.load();
+    _reader_count = &stripe.reader_counts[epoch & 1];
+    _reader_count->fetch_add(1);
+    if (cache._epoch.load() == epoch)
+    {
+      return; // a writer that advances the epoch from here on waits for this reader
+    }
+    _reader_count->fetch_sub(1, std::memory_order_release); // the writer might have missed this reader, so retry
+  }
+}
+
+ClockCache::ReadGuard::~ReadGuard()
+{
+  _reader_count->fetch_sub(1, std::memory_order_release);
+}
+
+ClockCache::ClockCache(std::size_t max_size, std::size_t shard_count)
+{
+  const std::size_t power_of_two_shard_count = roundUpToPowerOfTwo(shard_count);
+  _shard_bits = 0;
+  while ((std::size_t{1} << _shard_bits) < power_of_two_shard_count)
+  {
+    ++_shard_bits;
+  }
+  _shard_mask = power_of_two_shard_count - 1;
+  _shards = std::make_unique<Shard[]>(power_of_two_shard_count);
+
+  const std::size_t shard_capacity = std::max<std::size_t>(
+      1, (max_size + power_of_two_shard_count - 1) / power_of_two_shard_count); // rounded up, at least one element
+  const std::size_t bucket_count = roundUpToPowerOfTwo(shard_capacity);
+  for (std::size_t i = 0; i < power_of_two_shard_count; ++i)
+  {
+    _shards[i].buckets = std::make_unique<std::atomic<Node*>[]>(bucket_count);
+    _shards[i].bucket_mask = bucket_count - 1;
+    _shards[i].clock = std::make_unique<Node*[]>(shard_capacity);
+    _shards[i].capacity = shard_capacity;
+    _shards[i].retired_nodes.reserve(RetiredNodesToReclaim);
+  }
+}
+
+ClockCache::~ClockCache()
+{
+  for (std::size_t i = 0; i <= _shard_mask; ++i)
+  {
+    for (std::size_t j = 0; j < _shards[i].size; ++j)
+    {
+      delete _shards[i].clock[j];
+    }
+    for (Node* node : _shards[i].retired_nodes)
+    {
+      delete node;
+    }
+  }
+}
+
+void ClockCache::Insert(const std::string& key, const Element& element)
+{
+  const std::size_t hash = std::hash<std::string>{}(key);
+  std::unique_ptr<Node> node = std::make_unique<Node>();
+  node->key = key;
+  node->hash = hash;
+  node->element = std::make_shared<const Element>(element);
+
+  std::vector<Node*> reclaimed_nodes; // deleted after the lock
+  Shard& shard = getShard(hash);
+  {
+    std::lock_guard lock(shard.mutex);
+    std::atomic<Node*>& bucket = getBucket(shard, hash);
+    std::atomic<Node*>* link = &bucket;
+    Node* existing_node = link->load(std::memory_order_relaxed);
+    while (existing_node != nullptr && (existing_node->hash != hash || existing_node->key != key))
+    {
+      link = &existing_node->next;
+      existing_node = link->load(std::memory_order_relaxed);
+    }
+
+    if (existing_node != nullptr)
+    {
+      // replace the existing node, concurrent readers either see the old or the new one
+      node->next.store(existing_node->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      node->referenced.store(true, std::memory_order_relaxed);
+      node->clock_index = existing_node->clock_index;
+      shard.clock[node->clock_index] = node.get();
+      link->store(node.release(), std::memory_order_release);
+      retire(shard, existing_node, reclaimed_nodes);
+      if (_statistics != nullptr)
+      {
+        _statistics->RecordInsert();
+      }
+    }
+    else
+    {
+      const bool is_full = shard.size == shard.capacity;
+      const TimePoint now = Clock::now();
+      bool is_evicted_element_expired = false;
+      if (is_full)
+      {
+        node->clock_index = evict(shard, now);
+        Node* evicted_node = shard.clock[node->clock_index];
+        is_evicted_element_expired = isExpired(*evicted_node->element, now);
+        unlink(shard, evicted_node);
+        retire(shard, evicted_node, reclaimed_nodes);
+      }
+      else
+      {
+        node->clock_index = shard.size++;
+      }
+      node->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed); // after the unlink
+      shard.clock[node->clock_index] = node.get();
+      bucket.store(node.release(), std::memory_order_release);
+      if (_statistics != nullptr)
+      {
+        _statistics->RecordInsert();
+        if (!is_full)
+        {
+          _statistics->AddToSize(1);
+        }
+        else if (is_evicted_element_expired)
+        {
+          _statistics->RecordExpiration();
+        }
+        else
+        {
+          _statistics->RecordEviction();
+        }
+      }
+    }
+  }
+
+  for (Node* reclaimed_node : reclaimed_nodes)
+  {
+    delete reclaimed_node;
+  }
+}
+
+Cache::Element ClockCache::Get(const std::string& key) const
+{
+  if (std::shared_ptr<const Element> element = GetShared(key); element != nullptr)
+  {
+    return *element;
+  }
+  return InvalidElement;
+}
+
+void ClockCache::Remove(const std::string& key)
+{
+  const std::size_t hash = std::hash<std::string>{}(key);
+  std::vector<Node*> reclaimed_nodes; // deleted after the lock
+  Shard& shard = getShard(hash);
+  {
+    std::lock_guard lock(shard.mutex);
+    Node* node = getBucket(shard, hash).load(std::memory_order_relaxed);
+    while (node != nullptr && (node->hash != hash || node->key != key))
+    {
+      node = node->next.load(std::memory_order_relaxed);
+    }
+    if (node == nullptr)
+    {
+      return;
+    }
+
+    // keep the used clock entries contiguous by moving the last one into the removed one
+    unlink(shard, node);
+    const std::size_t last_clock_index = --shard.size;
+    if (node->clock_index != last_clock_index)
+    {
+      Node* last_node = shard.clock[last_clock_index];
+      last_node->clock_index = node->clock_index;
+      shard.clock[node->clock_index] = last_node;
+    }
+    retire(shard, node, reclaimed_nodes);
+    if (_statistics != nullptr)
+    {
+      _statistics->AddToSize(-1);
+    }
+  }
+
+  for (Node* reclaimed_node : reclaimed_nodes)
+  {
+    delete reclaimed_node;
+  }
+}
+
+std::shared_ptr<const Cache::Element> ClockCache::GetShared(const std::string& key) const
+{
+  ReadGuard guard(*this);
+  const Node* node = find(key);
+  if (node == nullptr || isExpired(*node->element, Clock::now()))
+  {
+    if (_statistics != nullptr)
+    {
+      _statistics->RecordMiss();
+    }
+    return nullptr; // expired elements stay in the clock until they are evicted, which does not need a reference bit
+  }
+
+  if (!node->referenced.load(std::memory_order_relaxed))
+  {
+    // only write if necessary, so that hits of hot keys do not invalidate the cache line over and over again
+    node->referenced.store(true, std::memory_order_relaxed);
+  }
+  if (_statistics != nullptr)
+  {
+    _statistics->RecordHit();
+  }
+  return node->element; // copied while the guard keeps the node alive
+}
+
+std::shared_ptr<const Cache::Element> ClockCache::Peek(const std::string& key) const
+{
+  ReadGuard guard(*this);
+  const Node* node = find(key);
+  if (node == nullptr || isExpired(*node->element, Clock::now()))
+  {
+    return nullptr;
+  }
+  return node->element; // without setting the reference bit
+}
+
+ClockCache::Shard& ClockCache::getShard(std::size_t hash) const
+{
+  return _shards[hash & _shard_mask];
+}
+
+std::atomic<ClockCache::Node*>& ClockCache::getBucket(const Shard& shard, std::size_t hash) const
+{
+  return shard.buckets[(hash >> _shard_bits) & shard.bucket_mask];
+}
+
+const ClockCache::Node* ClockCache::find(const std::string& key) const
+{
+  const std::size_t hash = std::hash<std::string>{}(key);
+  const Node* node = getBucket(getShard(hash), hash).load(std::memory_order_acquire);
+  while (node != nullptr && (node->hash != hash || node->key != key))
+  {
+    node = node->next.load(std::memory_order_acquire);
+  }
+  return node;
+}
+
+void ClockCache::unlink(Shard& shard, Node* node) const
+{
+  // readers that are currently at the node can still follow its next pointer, which is not modified
+  std::atomic<Node*>* link = &getBucket(shard, node->hash);
+  while (link->load(std::memory_order_relaxed) != node)
+  {
+    link = &link->load(std::memory_order_relaxed)->next;
+  }
+  link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+void ClockCache::retire(Shard& shard, Node* node, std::vector<Node*>& reclaimed_nodes) const
+{
+  shard.retired_nodes.push_back(node);
+  if (shard.retired_nodes.size() >= RetiredNodesToReclaim)
+  {
+    waitForReaders();
+    reclaimed_nodes.reserve(RetiredNodesToReclaim);
+    std::swap(reclaimed_nodes, shard.retired_nodes);
+  }
+}
+
+void ClockCache::waitForReaders() const
+{
+  // Readers that enter after the epoch has been advanced cannot reach nodes that have been unlinked before. Readers
+  // that entered before are counted by the parity of the previous epoch, so it is sufficient to wait for those.
+  std::lock_guard lock(_reclamation_mutex);
+  const std::uint64_t previous_epoch = _epoch.fetch_add(1);
+  for (const ReaderStripe& stripe : _reader_stripes)
+  {
+    while (stripe.reader_counts[previous_epoch & 1].load() != 0)
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+std::size_t ClockCache::evict(Shard& shard, const TimePoint& now)
+{
+  // terminates after at most one full sweep, since the sweep clears all reference bits
+  while (!isExpired(*shard.clock[shard.hand]->element, now) &&
+         shard.clock[shard.hand]->referenced.exchange(false, std::memory_order_relaxed))
+  {
+    shard.hand = (shard.hand + 1) % shard.capacity;
+  }
+
+  const std::size_t clock_index = shard.hand;
+  shard.hand = (shard.hand + 1) % shard.capacity;
+  return clock_index;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Bounded cache that approximates LRU eviction with the CLOCK algorithm. In contrast to LRUCache, a cache hit does not
+ * reorder anything, it only sets the element's reference bit. Lookups are lock-free: readers traverse the hash chains
+ * through atomic pointers and only announce themselves in one of several padded reader counters, so concurrent hits
+ * of the same keys do not write to a shared cache line. Writers are serialized per shard. They never modify a
+ * published node but replace it, and free unlinked nodes only after all readers that might still see them have
+ * finished (epoch-based reclamation, amortized over several writes). The eviction work is done on insertion: the clock
+ * hand sweeps over the elements, clears set reference bits and evicts the first element that has not been referenced
+ * since the last sweep.
+ *
+ * Like UnorderedMapCache, the keys are distributed over shards. Each shard holds up to max_size / shard_count elements
+ * and evicts independently, so the eviction order is only approximately global. Expired elements are treated as
+ * non-existent and are the first ones to be evicted, regardless of their reference bit. Statistics are recorded if they
+ * have been set.
+ */
+class ClockCache : public Cache
+{
+public:
+  ClockCache(std::size_t max_size = 1000, std::size_t shard_count = 16); // shard_count is rounded up to a power of two
+  virtual ~ClockCache();
+
+  virtual void Insert(const std::string& key, const Element& element) override;
+  virtual Element Get(const std::string& key) const override;
+  virtual void Remove(const std::string& key) override;
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
+
+private:
+  // number of padded reader counters, threads are assigned round robin
+  static constexpr std::size_t ReaderStripeCount = 64;
+  // number of unlinked nodes a shard collects before it waits for the readers and frees them
+  static constexpr std::size_t RetiredNodesToReclaim = 64;
+
+  struct Node
+  {
+    std::string key;
+    std::size_t hash = 0;
+    std::shared_ptr<const Element> element; // immutable once the node is published
+    std::atomic<Node*> next = nullptr;
+    mutable std::atomic<bool> referenced = false;
+    std::size_t clock_index = 0; // only accessed by writers
+  };
+
+  struct alignas(64) ReaderStripe
+  {
+    std::array<std::atomic<std::size_t>, 2> reader_counts = {}; // active readers by parity of the epoch they entered
+  };
+
+  struct alignas(64) Shard
+  {
+    // read by readers, written by writers
+    std::unique_ptr<std::atomic<Node*>[]> buckets;
+    std::size_t bucket_mask = 0;
+
+    // only accessed by writers
+    alignas(64) std::mutex mutex;
+    std::unique_ptr<Node*[]> clock; // the first size entries are in use
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t hand = 0;
+    std::vector<Node*> retired_nodes; // unlinked, but possibly still seen by readers
+  };
+
+  class ReadGuard
+  {
+  public:
+    ReadGuard(const ClockCache& cache);
+    ~ReadGuard();
+
+  private:
+    std::atomic<std::size_t>* _reader_count;
+  };
+
+  Shard& getShard(std::size_t hash) const;
+  std::atomic<Node*>& getBucket(const Shard& shard, std::size_t hash) const;
+  const Node* find(const std::string& key) const; // to be called with a ReadGuard
+  void unlink(Shard& shard, Node* node) const;
+  void retire(Shard& shard, Node* node, std::vector<Node*>& reclaimed_nodes) const;
+  void waitForReaders() const;
+  static std::size_t evict(Shard& shard, const TimePoint& now);
+
+  std::size_t _shard_bits;
+  std::size_t _shard_mask;
+  std::unique_ptr<Shard[]> _shards;
+
+  alignas(64) mutable std::atomic<std::uint64_t> _epoch = 0;
+  mutable std::array<ReaderStripe, ReaderStripeCount> _reader_stripes;
+  mutable std::mutex _reclamation_mutex;
+};
+
+} // namespace mse
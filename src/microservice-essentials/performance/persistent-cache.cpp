@@ -0,0 +1,547 @@
+#include "persistent-cache.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <microservice-essentials/observability/logger.h>
+#include <stdexcept>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace mse;
+
+namespace
+{
+
+constexpr char SnapshotMagic[8] = {'M', 'S', 'E', 'C', 'A', 'C', 'H', 'E'};
+constexpr std::uint32_t SnapshotVersion = 2; // version 1 did not contain tags
+constexpr std::int64_t NeverExpires = std::numeric_limits<std::int64_t>::max();
+constexpr std::size_t MinPruneThreshold = 1024;
+
+/**
+ * Read-only view of a file's content, memory mapped where available.
+ */
+class MappedFile
+{
+public:
+  MappedFile(const std::string& file_path)
+  {
+#ifndef _WIN32
+    const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+    {
+      return;
+    }
+    struct stat file_status;
+    if (::fstat(file_descriptor, &file_status) == 0 && file_status.st_size > 0)
+    {
+      void* address = ::mmap(nullptr, static_cast<std::size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE,
+                             file_descriptor, 0);
+      if (address != MAP_FAILED)
+      {
+        _data = std::string_view(static_cast<const char*>(address), static_cast<std::size_t>(file_status.st_size));
+      }
+    }
+    ::close(file_descriptor); // the mapping stays valid
+    _exists = true;
+#else
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file)
+    {
+      return;
+    }
+    _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    _data = _buffer;
+    _exists = true;
+#endif
+  }
+
+  ~MappedFile()
+  {
+#ifndef _WIN32
+    if (!_data.empty())
+    {
+      ::munmap(const_cast<char*>(_data.data()), _data.size());
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Exists() const
+  {
+    return _exists;
+  }
+  std::string_view Data() const
+  {
+    return _data;
+  }
+
+private:
+  bool _exists = false;
+  std::string_view _data;
+#ifdef _WIN32
+  std::string _buffer;
+#endif
+};
+
+template <typename T> void write(std::string& buffer, const T& value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::string& buffer, std::string_view value)
+{
+  write(buffer, static_cast<std::uint64_t>(value.size()));
+  buffer.append(value);
+}
+
+// writes the buffer to the file and syncs it to the storage device, returns false on failure
+bool writeFile(const std::string& file_path, const std::string& buffer)
+{
+#ifndef _WIN32
+  const int file_descriptor = ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file_descriptor < 0)
+  {
+    return false;
+  }
+  for (std::size_t written = 0; written < buffer.size();)
+  {
+    const ssize_t result = ::write(file_descriptor, buffer.data() + written, buffer.size() - written);
+    if (result < 0 && errno != EINTR)
+    {
+      ::close(file_descriptor);
+      return false;
+    }
+    written += result > 0 ? static_cast<std::size_t>(result) : 0;
+  }
+  const bool synced = ::fsync(file_descriptor) == 0;
+  return ::close(file_descriptor) == 0 && synced;
+#else
+  std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+  file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  file.flush();
+  return static_cast<bool>(file);
+#endif
+}
+
+// syncs the directory of the file, so that a rename within it survives a power loss
+void syncDirectory(const std::string& file_path)
+{
+#ifndef _WIN32
+  const std::string::size_type separator = file_path.find_last_of('/');
+  const std::string directory =
+      separator == std::string::npos ? "." : file_path.substr(0, std::max<std::string::size_type>(separator, 1));
+  const int file_descriptor = ::open(directory.c_str(), O_RDONLY);
+  if (file_descriptor >= 0)
+  {
+    ::fsync(file_descriptor);
+    ::close(file_descriptor);
+  }
+#else
+  (void)file_path;
+#endif
+}
+
+/**
+ * Reads values from a snapshot and throws if the snapshot ends unexpectedly.
+ */
+class SnapshotReader
+{
+public:
+  SnapshotReader(std::string_view data) : _data(data)
+  {
+  }
+
+  template <typename T> T Read()
+  {
+    T value;
+    std::memcpy(&value, take(sizeof(T)).data(), sizeof(T)); // the data is not necessarily aligned
+    return value;
+  }
+  std::string_view ReadString()
+  {
+    return take(static_cast<std::size_t>(Read<std::uint64_t>()));
+  }
+
+private:
+  std::string_view take(std::size_t size)
+  {
+    if (size > _data.size())
+    {
+      throw std::runtime_error("corrupt cache snapshot");
+    }
+    std::string_view taken = _data.substr(0, size);
+    _data.remove_prefix(size);
+    return taken;
+  }
+
+  std::string_view _data;
+};
+
+// steady clock time points are meaningless after a restart, so they are persisted as system clock time points
+std::int64_t toPersistedTime(const Cache::TimePoint& time_point, const Cache::TimePoint& steady_now,
+                             const std::chrono::system_clock::time_point& system_now)
+{
+  if (time_point == Cache::TimePoint::max())
+  {
+    return NeverExpires;
+  }
+  const auto system_time_point =
+      system_now + std::chrono::duration_cast<std::chrono::system_clock::duration>(time_point - steady_now);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(system_time_point.time_since_epoch()).count();
+}
+
+Cache::TimePoint fromPersistedTime(std::int64_t persisted_time, const Cache::TimePoint& steady_now,
+                                   const std::chrono::system_clock::time_point& system_now)
+{
+  if (persisted_time == NeverExpires)
+  {
+    return Cache::TimePoint::max();
+  }
+  const std::chrono::system_clock::time_point system_time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(persisted_time)));
+  return steady_now + std::chrono::duration_cast<Cache::Clock::duration>(system_time_point - system_now);
+}
+
+std::optional<std::string> serializeString(const std::any& data)
+{
+  if (const std::string* string_data = std::any_cast<std::string>(&data); string_data != nullptr)
+  {
+    return *string_data;
+  }
+  if (const auto* shared_string_data = std::any_cast<std::shared_ptr<const std::string>>(&data);
+      shared_string_data != nullptr && *shared_string_data != nullptr)
+  {
+    return **shared_string_data;
+  }
+  return std::nullopt;
+}
+
+std::any deserializeString(std::string_view serialized_data)
+{
+  return std::string(serialized_data);
+}
+
+} // namespace
+
+CacheSerializer CacheSerializer::ForStrings()
+{
+  return CacheSerializer{serializeString, deserializeString};
+}
+
+PersistentCache::PersistentCache(std::shared_ptr<Cache> real_cache, const std::string& file_path,
+                                 const CacheSerializer& serializer)
+    : _real_cache(real_cache), _file_path(file_path), _serializer(serializer), _prune_threshold(MinPruneThreshold)
+{
+}
+
+PersistentCache::~PersistentCache()
+{
+  {
+    std::lock_guard lock(_background_mutex);
+    _stop_background_tasks = true;
+  }
+  _background_condition.notify_all();
+  if (_background_thread.joinable())
+  {
+    _background_thread.join();
+  }
+}
+
+void PersistentCache::Insert(const std::string& key, const Element& element)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+  _real_cache->Insert(key, element); // before the key is tracked, see eraseMissingKeys
+  bool prune = false;
+  {
+    std::lock_guard lock(_keys_mutex);
+    _keys[key] = ++_insertion_count;
+    if (_keys.size() > _prune_threshold)
+    {
+      prune = true;
+      _prune_threshold = 2 * _keys.size(); // no other insert requests pruning in the meantime
+    }
+  }
+  if (prune)
+  {
+    requestPruning();
+  }
+}
+
+Cache::Element PersistentCache::Get(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return Cache::InvalidElement;
+  }
+  return _real_cache->Get(key);
+}
+
+void PersistentCache::Remove(const std::string& key)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+  _real_cache->Remove(key);
+  std::lock_guard lock(_keys_mutex);
+  _keys.erase(key);
+}
+
+std::shared_ptr<const Cache::Element> PersistentCache::GetShared(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+  return _real_cache->GetShared(key);
+}
+
+std::shared_ptr<const Cache::Element> PersistentCache::Peek(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+  return _real_cache->Peek(key);
+}
+
+std::size_t PersistentCache::LoadSnapshot()
+{
+  const MappedFile file(_file_path);
+  if (!file.Exists())
+  {
+    return 0;
+  }
+
+  SnapshotReader reader(file.Data());
+  for (char expected_character : SnapshotMagic)
+  {
+    if (reader.Read<char>() != expected_character)
+    {
+      throw std::runtime_error("not a cache snapshot: " + _file_path);
+    }
+  }
+  const std::uint32_t version = reader.Read<std::uint32_t>();
+  if (version < 1 || version > SnapshotVersion)
+  {
+    throw std::runtime_error("unsupported cache snapshot version: " + std::to_string(version));
+  }
+
+  const Cache::TimePoint steady_now = Cache::Clock::now();
+  const std::chrono::system_clock::time_point system_now = std::chrono::system_clock::now();
+  const std::uint64_t element_count = reader.Read<std::uint64_t>();
+  std::size_t loaded_count = 0;
+  for (std::uint64_t i = 0; i < element_count; ++i)
+  {
+    const std::string_view key = reader.ReadString();
+    Element element;
+    element.status.code = static_cast<StatusCode>(reader.Read<std::int32_t>());
+    element.status.details = reader.ReadString();
+    element.insertion_time = fromPersistedTime(reader.Read<std::int64_t>(), steady_now, system_now);
+    element.expiry_time = fromPersistedTime(reader.Read<std::int64_t>(), steady_now, system_now);
+    element.weight = static_cast<std::size_t>(reader.Read<std::uint64_t>());
+    if (version >= 2)
+    {
+      for (std::uint64_t tag_count = reader.Read<std::uint64_t>(); tag_count > 0; --tag_count)
+      {
+        element.tags.emplace_back(reader.ReadString());
+      }
+    }
+    const std::string_view serialized_data = reader.ReadString();
+    if (element.expiry_time <= steady_now)
+    {
+      continue;
+    }
+    element.data = _serializer.deserialize(serialized_data);
+    Insert(std::string(key), element);
+    ++loaded_count;
+  }
+  return loaded_count;
+}
+
+std::size_t PersistentCache::SaveSnapshot()
+{
+  if (_real_cache == nullptr)
+  {
+    return 0;
+  }
+
+  KeyVersions keys;
+  {
+    std::lock_guard lock(_keys_mutex);
+    keys.assign(_keys.begin(), _keys.end());
+  }
+
+  std::string buffer(SnapshotMagic, sizeof(SnapshotMagic));
+  write(buffer, SnapshotVersion);
+  const std::size_t element_count_offset = buffer.size();
+  write(buffer, std::uint64_t(0)); // updated after all elements have been written
+
+  const Cache::TimePoint steady_now = Cache::Clock::now();
+  const std::chrono::system_clock::time_point system_now = std::chrono::system_clock::now();
+  std::uint64_t element_count = 0;
+  KeyVersions missing_keys;
+  for (const auto& [key, insertion_number] : keys)
+  {
+    std::shared_ptr<const Element> element = _real_cache->Peek(key);
+    if (element == nullptr)
+    {
+      missing_keys.emplace_back(key, insertion_number); // e.g. evicted by the real cache
+      continue;
+    }
+    std::optional<std::string> serialized_data = _serializer.serialize(element->data);
+    if (!serialized_data.has_value())
+    {
+      continue;
+    }
+    writeString(buffer, key);
+    write(buffer, static_cast<std::int32_t>(element->status.code));
+    writeString(buffer, element->status.details);
+    write(buffer, toPersistedTime(element->insertion_time, steady_now, system_now));
+    write(buffer, toPersistedTime(element->expiry_time, steady_now, system_now));
+    write(buffer, static_cast<std::uint64_t>(element->weight));
+    write(buffer, static_cast<std::uint64_t>(element->tags.size()));
+    for (const std::string& tag : element->tags)
+    {
+      writeString(buffer, tag);
+    }
+    writeString(buffer, serialized_data.value());
+    ++element_count;
+  }
+  std::memcpy(buffer.data() + element_count_offset, &element_count, sizeof(element_count));
+
+  eraseMissingKeys(missing_keys);
+
+  std::lock_guard lock(_save_mutex);
+  const std::string temporary_file_path = _file_path + ".tmp";
+  if (!writeFile(temporary_file_path, buffer)) // synced, so that the renamed file is never truncated
+  {
+    throw std::runtime_error("failed to write cache snapshot: " + temporary_file_path);
+  }
+#ifdef _WIN32
+  std::remove(_file_path.c_str()); // rename does not replace existing files on windows
+#endif
+  if (std::rename(temporary_file_path.c_str(), _file_path.c_str()) != 0)
+  {
+    throw std::runtime_error("failed to replace cache snapshot: " + _file_path);
+  }
+  syncDirectory(_file_path);
+  return element_count;
+}
+
+void PersistentCache::StartPeriodicSnapshots(const Duration& interval)
+{
+  std::lock_guard lock(_background_mutex);
+  if (_snapshot_interval.has_value())
+  {
+    throw std::logic_error("periodic snapshots have already been started");
+  }
+  _snapshot_interval = interval;
+  startBackgroundThread();
+  _background_condition.notify_all();
+}
+
+void PersistentCache::requestPruning()
+{
+  std::lock_guard lock(_background_mutex);
+  _prune_requested = true;
+  startBackgroundThread();
+  _background_condition.notify_all();
+}
+
+void PersistentCache::startBackgroundThread()
+{
+  if (!_background_thread.joinable())
+  {
+    _background_thread = std::thread([this]() { runBackgroundTasks(); });
+  }
+}
+
+void PersistentCache::runBackgroundTasks()
+{
+  std::unique_lock lock(_background_mutex);
+  TimePoint next_snapshot_time = TimePoint::min(); // min while no snapshot is scheduled
+  while (!_stop_background_tasks)
+  {
+    if (_prune_requested)
+    {
+      _prune_requested = false;
+      lock.unlock();
+      pruneKeys();
+      lock.lock();
+      continue;
+    }
+    if (!_snapshot_interval.has_value())
+    {
+      _background_condition.wait(lock);
+      continue;
+    }
+    if (next_snapshot_time == TimePoint::min())
+    {
+      next_snapshot_time = Clock::now() + std::chrono::duration_cast<Clock::duration>(_snapshot_interval.value());
+    }
+    if (_background_condition.wait_until(lock, next_snapshot_time) == std::cv_status::no_timeout)
+    {
+      continue; // e.g. pruning has been requested
+    }
+    next_snapshot_time = TimePoint::min();
+    lock.unlock();
+    try
+    {
+      SaveSnapshot();
+    }
+    catch (const std::exception& e)
+    {
+      MSE_LOG_ERROR(std::string("failed to save cache snapshot: ") + e.what());
+    }
+    lock.lock();
+  }
+}
+
+void PersistentCache::pruneKeys()
+{
+  KeyVersions keys;
+  {
+    std::lock_guard lock(_keys_mutex);
+    keys.assign(_keys.begin(), _keys.end());
+  }
+  KeyVersions missing_keys;
+  for (const auto& [key, insertion_number] : keys)
+  {
+    if (_real_cache->Peek(key) == nullptr)
+    {
+      missing_keys.emplace_back(key, insertion_number);
+    }
+  }
+  eraseMissingKeys(missing_keys);
+}
+
+void PersistentCache::eraseMissingKeys(const KeyVersions& candidates)
+{
+  // an element that has been inserted after its key was found missing is in the real cache before its key gets a new
+  // insertion number (see Insert), so keys whose insertion number is unchanged are still missing
+  std::lock_guard lock(_keys_mutex);
+  for (const auto& [key, insertion_number] : candidates)
+  {
+    if (auto it = _keys.find(key); it != _keys.end() && it->second == insertion_number)
+    {
+      _keys.erase(it);
+    }
+  }
+  _prune_threshold = std::max(MinPruneThreshold, 2 * _keys.size());
+}
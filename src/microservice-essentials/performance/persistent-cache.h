@@ -0,0 +1,95 @@
+#pragma once
+
+#include <any>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Converts cached data to bytes and back, so that it can be persisted (see PersistentCache).
+ */
+struct CacheSerializer
+{
+  // returns nullopt for data that cannot be serialized, such elements are not persisted
+  std::function<std::optional<std::string>(const std::any&)> serialize;
+  std::function<std::any(std::string_view)> deserialize;
+
+  static CacheSerializer ForStrings(); // serializes std::string data (also if shared, see WithCachedObject)
+};
+
+/**
+ * Cache decorator that persists the elements of the real cache to a snapshot file, so that a restarted service can
+ * start with a warm cache instead of requesting everything again. Snapshots contain the key, status, insertion time,
+ * expiry time, weight, tags and serialized data of each element. They are written to a temporary file that is synced
+ * to the storage device before it replaces the previous snapshot, so that neither a crash nor a power loss leaves a
+ * partially written snapshot behind (Windows: the file is flushed, but not synced). Snapshots are loaded by memory
+ * mapping the file. Their format depends on the byte order of the machine.
+ * The keys of the inserted elements are tracked to know what to persist. Keys whose elements the real cache has dropped
+ * (e.g. evicted or expired) are pruned by SaveSnapshot and by a background thread whenever the number of tracked keys
+ * has doubled, so that they are bounded by the size of the real cache. The real cache is inspected with Peek, so
+ * neither snapshots nor pruning change its statistics or eviction order.
+ */
+class PersistentCache : public Cache
+{
+public:
+  using Duration = std::chrono::duration<double, std::milli>;
+
+  PersistentCache(std::shared_ptr<Cache> real_cache, const std::string& file_path,
+                  const CacheSerializer& serializer = CacheSerializer::ForStrings());
+  virtual ~PersistentCache();
+
+  virtual void Insert(const std::string& key, const Element& element) override;
+  virtual Element Get(const std::string& key) const override;
+  virtual void Remove(const std::string& key) override;
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
+
+  // inserts the elements of the snapshot that have not expired yet, returns their number (0 if there is no snapshot)
+  std::size_t LoadSnapshot();
+  std::size_t SaveSnapshot(); // returns the number of persisted elements
+  void StartPeriodicSnapshots(const Duration& interval); // calls SaveSnapshot periodically until destruction
+
+private:
+  using KeyVersions = std::vector<std::pair<std::string, std::uint64_t>>;
+
+  void requestPruning();
+  void startBackgroundThread(); // requires the background lock
+  void runBackgroundTasks();
+  void pruneKeys();
+  void eraseMissingKeys(const KeyVersions& candidates); // erases those that have not been inserted again
+
+  std::shared_ptr<Cache> _real_cache;
+  const std::string _file_path;
+  const CacheSerializer _serializer;
+
+  std::mutex _keys_mutex;
+  // the keys of all elements that might be in the real cache => the number of their last insertion
+  std::unordered_map<std::string, std::uint64_t> _keys;
+  std::uint64_t _insertion_count = 0;
+  std::size_t _prune_threshold; // number of keys that triggers pruning them
+  std::mutex _save_mutex;       // serializes writing the snapshot file
+
+  std::mutex _background_mutex;
+  std::condition_variable _background_condition;
+  std::optional<Duration> _snapshot_interval;
+  bool _prune_requested = false;
+  bool _stop_background_tasks = false;
+  std::thread _background_thread; // saves periodic snapshots and prunes the keys
+};
+
+} // namespace mse
@@ -0,0 +1,223 @@
+#include "tagged-cache.h"
+#include <algorithm>
+
+using namespace mse;
+
+namespace
+{
+constexpr std::size_t MinKeysToPrune = 1024;    // smaller indexes are not pruned
+constexpr std::size_t KeysToPrunePerInsert = 2; // removes stale keys faster than inserts add them
+} // namespace
+
+TaggedCache::TaggedCache(std::shared_ptr<Cache> real_cache) : _real_cache(real_cache)
+{
+}
+
+void TaggedCache::Insert(const std::string& key, const Element& element)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+
+  // before the key is indexed, so that unindexing a key (followed by its removal) never leaves its element cached
+  _real_cache->Insert(key, element);
+  KeyVersions keys_to_prune;
+  {
+    std::lock_guard lock(_mutex);
+    IndexEntry& entry = _keys[key];
+    entry.insertion_number = ++_insertion_count;
+    for (const std::string& tag : element.tags)
+    {
+      if (std::find(entry.tags.begin(), entry.tags.end(), tag) == entry.tags.end())
+      {
+        entry.tags.push_back(tag);
+      }
+      _tagged_keys[tag].insert(key);
+    }
+    if (entry.tags.size() > element.tags.size())
+    {
+      keys_to_prune.emplace_back(key, entry.insertion_number); // drops the tags of the replaced element
+    }
+    if (_keys.size() > MinKeysToPrune)
+    {
+      addKeysToPrune(keys_to_prune);
+    }
+  }
+  pruneKeys(keys_to_prune);
+}
+
+Cache::Element TaggedCache::Get(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return Cache::InvalidElement;
+  }
+
+  return _real_cache->Get(key);
+}
+
+void TaggedCache::Remove(const std::string& key)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+
+  {
+    std::lock_guard lock(_mutex);
+    if (auto it = _keys.find(key); it != _keys.end())
+    {
+      unindex(it);
+    }
+  }
+  _real_cache->Remove(key);
+}
+
+std::shared_ptr<const Cache::Element> TaggedCache::GetShared(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+
+  return _real_cache->GetShared(key);
+}
+
+std::shared_ptr<const Cache::Element> TaggedCache::Peek(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+  return _real_cache->Peek(key);
+}
+
+std::size_t TaggedCache::InvalidateTag(const std::string& tag)
+{
+  if (_real_cache == nullptr)
+  {
+    return 0;
+  }
+
+  std::vector<std::string> keys;
+  {
+    std::lock_guard lock(_mutex);
+    auto tagged_keys_it = _tagged_keys.find(tag);
+    if (tagged_keys_it == _tagged_keys.end())
+    {
+      return 0;
+    }
+    keys.assign(tagged_keys_it->second.begin(), tagged_keys_it->second.end()); // unindex erases
+    for (const std::string& key : keys)
+    {
+      unindex(_keys.find(key));
+    }
+  }
+  return remove(keys);
+}
+
+std::size_t TaggedCache::InvalidatePrefix(const std::string& prefix)
+{
+  if (_real_cache == nullptr)
+  {
+    return 0;
+  }
+
+  std::vector<std::string> keys;
+  {
+    std::lock_guard lock(_mutex);
+    for (auto it = _keys.lower_bound(prefix); it != _keys.end() && it->first.compare(0, prefix.size(), prefix) == 0;)
+    {
+      keys.push_back(it->first);
+      unindex(it++);
+    }
+  }
+  return remove(keys);
+}
+
+void TaggedCache::addKeysToPrune(KeyVersions& keys)
+{
+  auto it = _keys.upper_bound(_prune_position);
+  for (std::size_t i = 0; i < KeysToPrunePerInsert; ++i, ++it)
+  {
+    if (it == _keys.end())
+    {
+      it = _keys.begin(); // starts over
+    }
+    keys.emplace_back(it->first, it->second.insertion_number);
+  }
+  _prune_position = keys.back().first;
+}
+
+void TaggedCache::pruneKeys(const KeyVersions& keys)
+{
+  std::vector<std::shared_ptr<const Element>> elements;
+  elements.reserve(keys.size());
+  for (const auto& [key, insertion_number] : keys)
+  {
+    elements.push_back(_real_cache->Peek(key));
+  }
+
+  // an insertion number is assigned after the element has been inserted into the real cache, so if it is unchanged,
+  // the checked element is the one of that insertion or of a concurrent one whose tags are going to be indexed anyway
+  std::lock_guard lock(_mutex);
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    auto it = _keys.find(keys[i].first);
+    if (it == _keys.end() || it->second.insertion_number != keys[i].second)
+    {
+      continue;
+    }
+    if (elements[i] == nullptr)
+    {
+      unindex(it); // e.g. expired or evicted by the real cache
+      continue;
+    }
+    std::vector<std::string>& tags = it->second.tags;
+    for (auto tag_it = tags.begin(); tag_it != tags.end();)
+    {
+      if (std::find(elements[i]->tags.begin(), elements[i]->tags.end(), *tag_it) == elements[i]->tags.end())
+      {
+        unindexTag(it->first, *tag_it); // the tag of a replaced element
+        tag_it = tags.erase(tag_it);
+      }
+      else
+      {
+        ++tag_it;
+      }
+    }
+  }
+}
+
+std::size_t TaggedCache::remove(const std::vector<std::string>& keys)
+{
+  std::size_t removed_count = 0;
+  for (const std::string& key : keys)
+  {
+    removed_count += _real_cache->Peek(key) != nullptr ? 1 : 0; // the index might not be pruned yet
+    _real_cache->Remove(key);
+  }
+  return removed_count;
+}
+
+void TaggedCache::unindex(KeyIndex::iterator it)
+{
+  for (const std::string& tag : it->second.tags)
+  {
+    unindexTag(it->first, tag);
+  }
+  _keys.erase(it);
+}
+
+void TaggedCache::unindexTag(const std::string& key, const std::string& tag)
+{
+  if (auto tagged_keys_it = _tagged_keys.find(tag); tagged_keys_it != _tagged_keys.end())
+  {
+    tagged_keys_it->second.erase(key);
+    if (tagged_keys_it->second.empty())
+    {
+      _tagged_keys.erase(tagged_keys_it);
+    }
+  }
+}
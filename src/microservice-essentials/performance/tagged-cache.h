@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Cache decorator that supports invalidating elements in bulk, either all elements with a tag (see
+ * CachingRequestHook::Parameters::WithTags) or all elements whose key starts with a prefix. Both only visit the
+ * affected elements, so write paths can invalidate precisely what they changed instead of relying on short max ages.
+ * Elements are invalidated by removing them through the real cache, so decorators below this one stay consistent.
+ * Neither cache hits nor misses lock, and the real cache is never called under the lock of the index. Each insert into
+ * a large index checks a few indexed keys against the real cache, so that keys whose elements are no longer cached
+ * (e.g. evicted or expired) are pruned and the index stays below about twice the size of the real cache. The real
+ * cache is inspected with Peek, so pruning and counting invalidated elements change neither its statistics nor its
+ * eviction order. The tags of a replaced element are unindexed by checking the key against the real cache as well, so
+ * that concurrent inserts of a key never leave the cached element without its tags.
+ */
+class TaggedCache : public Cache
+{
+public:
+  TaggedCache(std::shared_ptr<Cache> real_cache);
+  virtual ~TaggedCache() = default;
+
+  virtual void Insert(const std::string& key, const Element& element) override;
+  virtual Element Get(const std::string& key) const override;
+  virtual void Remove(const std::string& key) override;
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
+
+  std::size_t InvalidateTag(const std::string& tag);       // returns the number of invalidated cached elements
+  std::size_t InvalidatePrefix(const std::string& prefix); // returns the number of invalidated cached elements
+
+private:
+  struct IndexEntry
+  {
+    std::vector<std::string> tags;
+    std::uint64_t insertion_number = 0; // changes whenever the key is inserted again
+  };
+  using KeyIndex = std::map<std::string, IndexEntry>; // ordered by key
+  using KeyVersions = std::vector<std::pair<std::string, std::uint64_t>>;
+
+  void addKeysToPrune(KeyVersions& keys);                          // requires the lock
+  void pruneKeys(const KeyVersions& keys);                         // must not hold the lock
+  std::size_t remove(const std::vector<std::string>& keys);        // removes unindexed keys from the real cache
+  void unindex(KeyIndex::iterator it);                             // requires the lock
+  void unindexTag(const std::string& key, const std::string& tag); // requires the lock
+
+  std::shared_ptr<Cache> _real_cache;
+
+  std::mutex _mutex;
+  KeyIndex _keys;
+  std::unordered_map<std::string, std::unordered_set<std::string>> _tagged_keys;
+  std::uint64_t _insertion_count = 0;
+  std::string _prune_position; // the last key that has been checked by pruning
+};
+
+} // namespace mse
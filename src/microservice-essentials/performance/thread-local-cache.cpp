@@ -0,0 +1,166 @@
+#include "thread-local-cache.h"
+#include <functional>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+using namespace mse;
+
+namespace
+{
+
+std::atomic<std::uint64_t> next_id = 0;
+
+struct L1Entry
+{
+  std::size_t hash;
+  std::string key;
+  std::uint64_t epoch;
+  std::uint64_t last_use;
+  // owned by the thread, so that handing out the element only touches this thread's reference count
+  std::shared_ptr<const std::shared_ptr<const Cache::Element>> element;
+};
+
+struct L1
+{
+  std::weak_ptr<void> owner;
+  std::vector<L1Entry> entries; // a few dozen entries are scanned faster than a hash map is looked up
+  std::uint64_t use_count = 0;
+};
+
+L1& getL1(std::uint64_t id, const std::shared_ptr<void>& owner)
+{
+  thread_local std::unordered_map<std::uint64_t, L1> l1_caches;
+  if (auto it = l1_caches.find(id); it != l1_caches.end())
+  {
+    return it->second;
+  }
+  // the L1 caches of destroyed instances are released here, as creating another L1 cache is rare
+  for (auto it = l1_caches.begin(); it != l1_caches.end();)
+  {
+    it = it->second.owner.expired() ? l1_caches.erase(it) : std::next(it);
+  }
+  L1& l1 = l1_caches[id];
+  l1.owner = owner;
+  return l1;
+}
+
+L1Entry* findEntry(L1& l1, std::size_t hash, const std::string& key)
+{
+  for (L1Entry& entry : l1.entries)
+  {
+    if (entry.hash == hash && entry.key == key)
+    {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+L1Entry* getEntryToReplace(L1& l1, std::size_t capacity)
+{
+  if (l1.entries.size() < capacity)
+  {
+    return &l1.entries.emplace_back();
+  }
+  L1Entry* least_recently_used = &l1.entries.front();
+  for (L1Entry& entry : l1.entries)
+  {
+    if (entry.last_use < least_recently_used->last_use)
+    {
+      least_recently_used = &entry;
+    }
+  }
+  return least_recently_used;
+}
+
+std::shared_ptr<const Cache::Element> share(const L1Entry& entry)
+{
+  return std::shared_ptr<const Cache::Element>(entry.element, entry.element->get());
+}
+
+} // namespace
+
+ThreadLocalCache::ThreadLocalCache(std::shared_ptr<Cache> real_cache, std::size_t l1_capacity)
+    : _real_cache(real_cache), _l1_capacity(l1_capacity), _id(next_id++), _alive(std::make_shared<bool>(true))
+{
+}
+
+void ThreadLocalCache::Insert(const std::string& key, const Element& element)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+  _real_cache->Insert(key, element);
+  getEpoch(std::hash<std::string>()(key)).fetch_add(1, std::memory_order_release); // after the change, see GetShared
+}
+
+Cache::Element ThreadLocalCache::Get(const std::string& key) const
+{
+  std::shared_ptr<const Element> element = GetShared(key);
+  return element == nullptr ? Cache::InvalidElement : *element;
+}
+
+void ThreadLocalCache::Remove(const std::string& key)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+  _real_cache->Remove(key);
+  getEpoch(std::hash<std::string>()(key)).fetch_add(1, std::memory_order_release);
+}
+
+std::shared_ptr<const Cache::Element> ThreadLocalCache::GetShared(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+
+  // the epoch is read before the real cache, so that a concurrent change leaves the L1 copy outdated
+  const std::size_t hash = std::hash<std::string>()(key);
+  const std::uint64_t epoch = getEpoch(hash).load(std::memory_order_acquire);
+  L1& l1 = getL1(_id, _alive);
+  L1Entry* entry = findEntry(l1, hash, key);
+  if (entry != nullptr && entry->epoch == epoch)
+  {
+    const Element& element = **entry->element;
+    if (element.expiry_time == TimePoint::max() || Clock::now() < element.expiry_time)
+    {
+      entry->last_use = ++l1.use_count;
+      return share(*entry);
+    }
+  }
+
+  std::shared_ptr<const Element> element = _real_cache->GetShared(key);
+  if (element == nullptr || _l1_capacity == 0)
+  {
+    return element;
+  }
+  if (entry == nullptr)
+  {
+    entry = getEntryToReplace(l1, _l1_capacity);
+    entry->hash = hash;
+    entry->key = key;
+  }
+  entry->epoch = epoch;
+  entry->last_use = ++l1.use_count;
+  entry->element = std::make_shared<const std::shared_ptr<const Element>>(std::move(element));
+  return share(*entry);
+}
+
+std::shared_ptr<const Cache::Element> ThreadLocalCache::Peek(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+  return _real_cache->Peek(key); // bypasses L1
+}
+
+std::atomic<std::uint64_t>& ThreadLocalCache::getEpoch(std::size_t hash) const
+{
+  return _epochs[hash % EpochStripeCount].value;
+}
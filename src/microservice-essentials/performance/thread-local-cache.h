@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <string>
+
+namespace mse
+{
+
+/**
+ * Cache decorator that keeps a small, unsynchronized cache per thread (L1) in front of the shared real cache (L2), so
+ * that the hottest elements, e.g. constant responses that never expire, are served without touching memory that is
+ * written by other threads. L1 hits only read a version counter (epoch) that Insert and Remove increment after
+ * changing the real cache, so that outdated L1 copies are detected. The epochs are striped by the key's hash to keep
+ * unrelated writes from invalidating all L1 caches.
+ * Only Insert and Remove through this decorator invalidate L1 copies, elements that the real cache evicts may still be
+ * served from L1 until they expire. Decorators that remove elements in bulk (e.g. TaggedCache) should wrap this one.
+ * L1 hits are not recorded in statistics, the statistics of the real cache count L1 misses only.
+ */
+class ThreadLocalCache : public Cache
+{
+public:
+  ThreadLocalCache(std::shared_ptr<Cache> real_cache, std::size_t l1_capacity = 32);
+  virtual ~ThreadLocalCache() = default;
+
+  virtual void Insert(const std::string& key, const Element& element) override;
+  virtual Element Get(const std::string& key) const override;
+  virtual void Remove(const std::string& key) override;
+  // the returned handle is owned by the calling thread, so that copying it does not contend with other threads
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
+
+private:
+  static constexpr std::size_t EpochStripeCount = 64;
+  struct alignas(64) Epoch // aligned to a cache line, so that writes to one stripe do not slow down reading others
+  {
+    std::atomic<std::uint64_t> value = 0;
+  };
+
+  std::atomic<std::uint64_t>& getEpoch(std::size_t hash) const;
+
+  std::shared_ptr<Cache> _real_cache;
+  const std::size_t _l1_capacity;
+  const std::uint64_t _id;            // identifies the L1 caches of this instance, addresses might be reused
+  const std::shared_ptr<void> _alive; // expires on destruction, so that threads can release the L1 caches
+  mutable std::array<Epoch, EpochStripeCount> _epochs;
+};
+
+} // namespace mse
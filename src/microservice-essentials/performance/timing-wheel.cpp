@@ -0,0 +1,89 @@
+#include "timing-wheel.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace mse;
+
+TimingWheel::TimingWheel(const Duration& resolution, const TimePoint& start_time)
+    : _resolution(resolution), _start_time(start_time)
+{
+}
+
+void TimingWheel::Schedule(const std::string& key, const TimePoint& expiry_time)
+{
+  // the slot of the current tick has already been reported
+  place(Entry{key, std::max(toTick(expiry_time, true), _current_tick + 1)});
+  ++_size;
+}
+
+void TimingWheel::Advance(const TimePoint& now, const std::function<void(const std::string&)>& on_expired)
+{
+  const std::uint64_t target_tick = toTick(now, false);
+  while (_current_tick < target_tick)
+  {
+    if (_size == 0)
+    {
+      _current_tick = target_tick; // nothing to report, so the elapsed ticks can be skipped
+      return;
+    }
+    ++_current_tick;
+
+    // move the entries of higher levels down when the level below has completed a rotation
+    for (std::size_t level = 1; level < LevelCount; ++level)
+    {
+      if ((_current_tick & ((std::uint64_t(1) << (SlotBits * level)) - 1)) != 0)
+      {
+        break;
+      }
+      Slot entries;
+      entries.swap(_levels[level][(_current_tick >> (SlotBits * level)) & (SlotCount - 1)]);
+      for (Entry& entry : entries)
+      {
+        place(std::move(entry));
+      }
+    }
+
+    Slot& slot = _levels[0][_current_tick & (SlotCount - 1)];
+    _size -= slot.size();
+    for (const Entry& entry : slot)
+    {
+      on_expired(entry.key);
+    }
+    slot.clear(); // keeps the capacity for the next rotation
+  }
+}
+
+std::size_t TimingWheel::Size() const
+{
+  return _size;
+}
+
+std::uint64_t TimingWheel::toTick(const TimePoint& time_point, bool round_up) const
+{
+  if (time_point <= _start_time)
+  {
+    return 0;
+  }
+  const double ticks = (time_point - _start_time) / _resolution;
+  constexpr double max_ticks = static_cast<double>(std::uint64_t(1) << 62); // far beyond any reasonable expiry time
+  if (ticks >= max_ticks)
+  {
+    return static_cast<std::uint64_t>(max_ticks);
+  }
+  return static_cast<std::uint64_t>(round_up ? std::ceil(ticks) : std::floor(ticks));
+}
+
+void TimingWheel::place(Entry&& entry)
+{
+  const std::uint64_t delta = entry.tick - _current_tick;
+  std::size_t level = 0;
+  while (level + 1 < LevelCount && delta >= (std::uint64_t(1) << (SlotBits * (level + 1))))
+  {
+    ++level;
+  }
+  // entries beyond the range of the highest level are rescheduled when their slot comes due
+  const std::uint64_t slot_tick =
+      std::min(entry.tick, _current_tick + (std::uint64_t(1) << (SlotBits * LevelCount)) - 1);
+  _levels[level][(slot_tick >> (SlotBits * level)) & (SlotCount - 1)].push_back(std::move(entry));
+}
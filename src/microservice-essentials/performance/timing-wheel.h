@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Hierarchical timing wheel that keeps track of the expiry times of keys, so that expired keys can be found without
+ * scanning all keys. Time is divided into ticks of the given resolution. The first level has one slot per tick, each
+ * further level has slots that span all slots of the level below. Keys are scheduled into the level that matches the
+ * distance to their expiry time and are moved down a level whenever the lower level has completed a rotation.
+ * Scheduling is O(1), advancing is O(1) per elapsed tick plus O(1) amortized per scheduled key.
+ *
+ * Keys are reported once their expiry time has passed, at most one tick late. Keys cannot be unscheduled, so a key
+ * that is scheduled several times is reported several times. Users have to verify whether the key is actually expired.
+ * Not thread-safe.
+ */
+class TimingWheel
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = std::chrono::time_point<Clock>;
+  using Duration = std::chrono::duration<double, std::milli>;
+
+  TimingWheel(const Duration& resolution = std::chrono::seconds(1), const TimePoint& start_time = Clock::now());
+
+  void Schedule(const std::string& key, const TimePoint& expiry_time);
+  // calls on_expired for every key whose expiry time has passed until the given time
+  void Advance(const TimePoint& now, const std::function<void(const std::string&)>& on_expired);
+
+  std::size_t Size() const;
+
+private:
+  static constexpr std::size_t SlotBits = 6;
+  static constexpr std::size_t SlotCount = std::size_t(1) << SlotBits;
+  static constexpr std::size_t LevelCount = 4; // covers SlotCount^4 ticks, later expiry times are rescheduled
+
+  struct Entry
+  {
+    std::string key;
+    std::uint64_t tick;
+  };
+  using Slot = std::vector<Entry>;
+
+  std::uint64_t toTick(const TimePoint& time_point, bool round_up) const;
+  void place(Entry&& entry); // requires entry.tick >= _current_tick
+
+  Duration _resolution;
+  TimePoint _start_time;
+  std::uint64_t _current_tick = 0; // all entries up to this tick have been reported
+  std::size_t _size = 0;
+  std::array<std::array<Slot, SlotCount>, LevelCount> _levels;
+};
+
+} // namespace mse
@@ -0,0 +1,264 @@
+#include "w-tiny-lfu-cache.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+using namespace mse;
+
+namespace
+{
+
+std::uint64_t hash(const std::string& key)
+{
+  return static_cast<std::uint64_t>(std::hash<std::string>{}(key));
+}
+
+} // namespace
+
+FrequencySketch::FrequencySketch(std::size_t expected_key_count)
+{
+  // 4 counters per expected key keep the estimation error due to hash collisions small
+  std::size_t width = 16;
+  while (width < 4 * expected_key_count)
+  {
+    width <<= 1;
+  }
+  _counters.resize(depth * width, 0);
+  _width_mask = width - 1;
+  _sample_size = std::max<std::size_t>(10 * expected_key_count, width);
+}
+
+void FrequencySketch::Increment(std::uint64_t key_hash)
+{
+  bool incremented = false;
+  for (std::size_t row = 0; row < depth; ++row)
+  {
+    if (std::uint8_t& counter = _counters[index(key_hash, row)]; counter < max_count)
+    {
+      ++counter;
+      incremented = true;
+    }
+  }
+
+  if (incremented && ++_increment_count >= _sample_size)
+  {
+    age();
+  }
+}
+
+std::uint8_t FrequencySketch::Estimate(std::uint64_t key_hash) const
+{
+  std::uint8_t estimate = max_count;
+  for (std::size_t row = 0; row < depth; ++row)
+  {
+    estimate = std::min(estimate, _counters[index(key_hash, row)]);
+  }
+  return estimate;
+}
+
+std::size_t FrequencySketch::index(std::uint64_t key_hash, std::size_t row) const
+{
+  // derives an independent hash per row from the key's hash
+  static constexpr std::uint64_t seeds[depth] = {0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full,
+                                                 0xcbf29ce484222325ull};
+  std::uint64_t row_hash = (key_hash + seeds[row]) * 0x9e3779b97f4a7c15ull;
+  row_hash ^= row_hash >> 32;
+  return row * (_width_mask + 1) + (static_cast<std::size_t>(row_hash) & _width_mask);
+}
+
+void FrequencySketch::age()
+{
+  for (std::uint8_t& counter : _counters)
+  {
+    counter >>= 1;
+  }
+  _increment_count /= 2;
+}
+
+WTinyLFUCache::WTinyLFUCache(std::shared_ptr<Cache> real_cache, std::size_t max_size)
+    : _real_cache(real_cache), _window_max_size(std::max<std::size_t>(1, max_size / 100)),
+      _main_max_size(max_size > _window_max_size ? max_size - _window_max_size : 0),
+      _protected_max_size(_main_max_size * 4 / 5), _sketch(max_size)
+{
+}
+
+void WTinyLFUCache::Insert(const std::string& key, const Element& element)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+
+  std::unique_lock lock(_mutex);
+  if (_entries.find(key) == _entries.end())
+  {
+    // new elements always enter the window
+    _window.push_front(key);
+    _entries.emplace(key, Entry{Segment::window, _window.begin()});
+  }
+  _real_cache->Insert(key, element);
+
+  if (_window.size() > _window_max_size)
+  {
+    evictFromWindow();
+  }
+}
+
+Cache::Element WTinyLFUCache::Get(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return Cache::InvalidElement;
+  }
+
+  std::unique_lock lock(_mutex);
+  if (!onGet(key))
+  {
+    return Cache::InvalidElement;
+  }
+  Element element = _real_cache->Get(key);
+  if (!Cache::IsValid(element))
+  {
+    onMiss(key);
+  }
+  return element;
+}
+
+void WTinyLFUCache::Remove(const std::string& key)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+
+  std::unique_lock lock(_mutex);
+  if (auto it = _entries.find(key); it != _entries.end())
+  {
+    remove(it);
+    return;
+  }
+  _real_cache->Remove(key); // e.g. inserted into the real cache before it has been wrapped
+}
+
+std::shared_ptr<const Cache::Element> WTinyLFUCache::GetShared(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+
+  std::unique_lock lock(_mutex);
+  if (!onGet(key))
+  {
+    return nullptr;
+  }
+  std::shared_ptr<const Element> element = _real_cache->GetShared(key);
+  if (element == nullptr)
+  {
+    onMiss(key);
+  }
+  return element;
+}
+
+std::shared_ptr<const Cache::Element> WTinyLFUCache::Peek(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+  return _real_cache->Peek(key); // keeps the frequencies and the LRU order
+}
+
+bool WTinyLFUCache::onGet(const std::string& key) const
+{
+  _sketch.Increment(hash(key));
+
+  const auto it = _entries.find(key);
+  if (it == _entries.end())
+  {
+    return false;
+  }
+
+  Entry& entry = it->second;
+  switch (entry.segment)
+  {
+  case Segment::window:
+    _window.splice(_window.begin(), _window, entry.position);
+    break;
+  case Segment::probation:
+    // promote to the protected segment and demote the protected segment's least recently used element if necessary
+    _protected.splice(_protected.begin(), _probation, entry.position);
+    entry.segment = Segment::protected_;
+    if (_protected.size() > _protected_max_size)
+    {
+      _entries.at(_protected.back()).segment = Segment::probation;
+      _probation.splice(_probation.begin(), _protected, std::prev(_protected.end()));
+    }
+    break;
+  case Segment::protected_:
+    _protected.splice(_protected.begin(), _protected, entry.position);
+    break;
+  }
+  return true;
+}
+
+void WTinyLFUCache::onMiss(const std::string& key) const
+{
+  // the real cache has dropped the element on its own (e.g. expired), so its entry must not count towards the segments
+  if (auto it = _entries.find(key); it != _entries.end())
+  {
+    getList(it->second.segment).erase(it->second.position);
+    _entries.erase(it);
+  }
+}
+
+void WTinyLFUCache::evictFromWindow()
+{
+  const auto candidate = _entries.find(_window.back());
+  if (_probation.size() + _protected.size() < _main_max_size)
+  {
+    _probation.splice(_probation.begin(), _window, candidate->second.position);
+    candidate->second.segment = Segment::probation;
+    return;
+  }
+  if (_main_max_size == 0)
+  {
+    remove(candidate);
+    return;
+  }
+
+  // admit the candidate only if it is requested more frequently than the main segment's eviction candidate
+  const auto victim = _entries.find(!_probation.empty() ? _probation.back() : _protected.back());
+  if (_sketch.Estimate(hash(candidate->first)) > _sketch.Estimate(hash(victim->first)))
+  {
+    remove(victim);
+    _probation.splice(_probation.begin(), _window, candidate->second.position);
+    candidate->second.segment = Segment::probation;
+  }
+  else
+  {
+    remove(candidate);
+  }
+}
+
+void WTinyLFUCache::remove(std::unordered_map<std::string, Entry>::iterator it)
+{
+  const std::string key = it->first;
+  getList(it->second.segment).erase(it->second.position);
+  _entries.erase(it);
+  _real_cache->Remove(key);
+}
+
+std::list<std::string>& WTinyLFUCache::getList(Segment segment) const
+{
+  switch (segment)
+  {
+  case Segment::window:
+    return _window;
+  case Segment::probation:
+    return _probation;
+  case Segment::protected_:
+    break;
+  }
+  return _protected;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Approximates the access frequency of keys in a fixed amount of memory (count-min sketch with 4 bit counters).
+ * To adapt to changing access patterns, all counters are halved after a number of increments (aging).
+ */
+class FrequencySketch
+{
+public:
+  FrequencySketch(std::size_t expected_key_count);
+
+  void Increment(std::uint64_t key_hash);
+  std::uint8_t Estimate(std::uint64_t key_hash) const;
+
+private:
+  static constexpr std::size_t depth = 4;
+  static constexpr std::uint8_t max_count = 15;
+
+  std::size_t index(std::uint64_t key_hash, std::size_t row) const;
+  void age();
+
+  std::vector<std::uint8_t> _counters; // depth rows of width counters
+  std::size_t _width_mask;
+  std::size_t _sample_size;
+  std::size_t _increment_count = 0;
+};
+
+/**
+ * Cache decorator that implements the W-TinyLFU admission and eviction policy. New elements enter a small window LRU
+ * (1% of the capacity). Elements evicted from the window are only admitted to the main segmented LRU if they have been
+ * requested more frequently than the main's eviction candidate, so that one-hit wonders (e.g. scans) do not displace
+ * popular elements. The frequencies are recorded by Get, also for cache misses.
+ */
+class WTinyLFUCache : public Cache
+{
+public:
+  WTinyLFUCache(std::shared_ptr<Cache> real_cache, std::size_t max_size = 1000);
+  virtual ~WTinyLFUCache() = default;
+
+  virtual void Insert(const std::string& key, const Element& element) override;
+  virtual Element Get(const std::string& key) const override;
+  virtual void Remove(const std::string& key) override;
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
+
+private:
+  enum class Segment
+  {
+    window,
+    probation, // main elements that have not been requested since their admission
+    protected_ // main elements that have been requested at least once since their admission
+  };
+  struct Entry
+  {
+    Segment segment;
+    std::list<std::string>::iterator position;
+  };
+
+  bool onGet(const std::string& key) const;  // returns whether the key is in the cache
+  void onMiss(const std::string& key) const; // the key is tracked, but the real cache does not have its element
+  void evictFromWindow();
+  void remove(std::unordered_map<std::string, Entry>::iterator it);
+  std::list<std::string>& getList(Segment segment) const;
+
+  std::shared_ptr<Cache> _real_cache;
+  std::size_t _window_max_size;
+  std::size_t _main_max_size;
+  std::size_t _protected_max_size;
+
+  mutable std::mutex _mutex;
+  mutable FrequencySketch _sketch;
+  mutable std::unordered_map<std::string, Entry> _entries;
+  mutable std::list<std::string> _window; // most recently used first
+  mutable std::list<std::string> _probation;
+  mutable std::list<std::string> _protected;
+};
+
+} // namespace mse
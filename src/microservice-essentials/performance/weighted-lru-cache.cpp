@@ -0,0 +1,123 @@
+#include "weighted-lru-cache.h"
+#include <iterator>
+
+using namespace mse;
+
+WeightedLRUCache::WeightedLRUCache(std::shared_ptr<Cache> real_cache, std::size_t max_weight)
+    : _real_cache(real_cache), _max_weight(max_weight)
+{
+}
+
+void WeightedLRUCache::Insert(const std::string& key, const Element& element)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+
+  std::unique_lock lock(_mutex);
+  if (auto it = _entries.find(key); it != _entries.end())
+  {
+    remove(it->second);
+  }
+  if (element.weight > _max_weight)
+  {
+    _real_cache->Remove(key); // the replaced element must not outlive the new one
+    return;
+  }
+
+  // 1. ensure that there is enough budget left for the element
+  while (_weight + element.weight > _max_weight)
+  {
+    _real_cache->Remove(_lru.back().key);
+    remove(std::prev(_lru.end()));
+  }
+
+  // 2. insert element into the cache
+  _lru.push_front(Entry{key, element.weight});
+  _entries[key] = _lru.begin();
+  _weight += element.weight;
+  _real_cache->Insert(key, element);
+}
+
+Cache::Element WeightedLRUCache::Get(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return Cache::InvalidElement;
+  }
+
+  std::unique_lock lock(_mutex);
+  Element element = _real_cache->Get(key);
+  onGet(key, Cache::IsValid(element));
+  return element;
+}
+
+void WeightedLRUCache::Remove(const std::string& key)
+{
+  if (_real_cache == nullptr)
+  {
+    return;
+  }
+
+  std::unique_lock lock(_mutex);
+  if (auto it = _entries.find(key); it != _entries.end())
+  {
+    remove(it->second);
+  }
+  _real_cache->Remove(key);
+}
+
+std::shared_ptr<const Cache::Element> WeightedLRUCache::GetShared(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+
+  std::unique_lock lock(_mutex);
+  std::shared_ptr<const Element> element = _real_cache->GetShared(key);
+  onGet(key, element != nullptr);
+  return element;
+}
+
+std::shared_ptr<const Cache::Element> WeightedLRUCache::Peek(const std::string& key) const
+{
+  if (_real_cache == nullptr)
+  {
+    return nullptr;
+  }
+  return _real_cache->Peek(key); // keeps the LRU order
+}
+
+std::size_t WeightedLRUCache::GetWeight() const
+{
+  return _weight;
+}
+
+std::size_t WeightedLRUCache::GetMaxWeight() const
+{
+  return _max_weight;
+}
+
+void WeightedLRUCache::onGet(const std::string& key, bool is_cached) const
+{
+  if (auto it = _entries.find(key); it != _entries.end())
+  {
+    if (is_cached)
+    {
+      _lru.splice(_lru.begin(), _lru, it->second);
+    }
+    else
+    {
+      remove(it->second); // e.g. expired and reclaimed by the real cache
+    }
+  }
+}
+
+void WeightedLRUCache::remove(EntryList::iterator it) const
+{
+  _weight -= it->weight;
+  _entries.erase(it->key);
+  _lru.erase(it);
+}
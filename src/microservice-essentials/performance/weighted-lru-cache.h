@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mse
+{
+
+/**
+ * Cache decorator that implements a Least Recently Used (LRU) cache that is bounded by the total weight of its
+ * elements instead of their number, e.g. by their size in bytes (see CachingRequestHook::Parameters::WithWeigher).
+ * Least recently used elements are evicted until a new element fits into the budget. Elements that weigh more than
+ * the whole budget are not cached at all.
+ */
+class WeightedLRUCache : public Cache
+{
+public:
+  WeightedLRUCache(std::shared_ptr<Cache> real_cache, std::size_t max_weight);
+  virtual ~WeightedLRUCache() = default;
+
+  virtual void Insert(const std::string& key, const Element& element) override;
+  virtual Element Get(const std::string& key) const override;
+  virtual void Remove(const std::string& key) override;
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override;
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override;
+
+  std::size_t GetWeight() const; // total weight of the cached elements, e.g. for monitoring
+  std::size_t GetMaxWeight() const;
+
+private:
+  struct Entry
+  {
+    std::string key;
+    std::size_t weight;
+  };
+  using EntryList = std::list<Entry>;
+
+  void onGet(const std::string& key, bool is_cached) const;
+  void remove(EntryList::iterator it) const; // keeps the element in the real cache
+
+  std::shared_ptr<Cache> _real_cache;
+  const std::size_t _max_weight;
+  mutable std::atomic<std::size_t> _weight = 0; // read without the lock
+
+  mutable std::mutex _mutex;
+  mutable EntryList _lru; // most recently used first
+  mutable std::unordered_map<std::string, EntryList::iterator> _entries;
+};
+
+} // namespace mse
@@ -26,7 +26,7 @@ MaxPendingRquestsExceededCircuitBreakerStrategy ::~MaxPendingRquestsExceededCirc
 CircuitBreakerStatus MaxPendingRquestsExceededCircuitBreakerStrategy::GetStatus(const Context& context) const
 {
   std::shared_lock<std::shared_mutex> lk(_mutex);
-  if (const auto& requestDataCit = _request_data.find(context.AtOr("request", "UNKNOWN"));
+  if (const auto& requestDataCit = _request_data.find(context.AtOr(ContextKey::request, "UNKNOWN"));
       requestDataCit != _request_data.end() &&
       requestDataCit->second._pending_request_count > _max_pending_request_count)
   {
@@ -38,7 +38,7 @@ CircuitBreakerStatus MaxPendingRquestsExceededCircuitBreakerStrategy::GetStatus(
 void MaxPendingRquestsExceededCircuitBreakerStrategy::pre_process(const Context& context)
 {
   std::unique_lock<std::shared_mutex> lk(_mutex);
-  const std::string request_name = context.AtOr("request", "UNKNOWN");
+  const std::string request_name = context.AtOr(ContextKey::request, "UNKNOWN");
   uint32_t& pending_request_count = _request_data[request_name]._pending_request_count;
   pending_request_count++;
   if (pending_request_count == _max_pending_request_count + 1)
@@ -51,7 +51,7 @@ void MaxPendingRquestsExceededCircuitBreakerStrategy::pre_process(const Context&
 void MaxPendingRquestsExceededCircuitBreakerStrategy::post_process(const Context& context, Status /*status*/)
 {
   std::unique_lock<std::shared_mutex> lk(_mutex);
-  const std::string request_name = context.AtOr("request", "UNKNOWN");
+  const std::string request_name = context.AtOr(ContextKey::request, "UNKNOWN");
   uint32_t& pending_request_count = _request_data[request_name]._pending_request_count;
   pending_request_count--;
   if (pending_request_count == _max_pending_request_count)
@@ -94,39 +94,100 @@ RetryRequestHook::Parameters::Parameters(std::shared_ptr<RetryBackoffStrategy> s
 {
 }
 
+RetryRequestHook::Parameters& RetryRequestHook::Parameters::WithExecutor(std::shared_ptr<Executor> executor_)
+{
+  executor = executor_;
+  return *this;
+}
+
+RetryRequestHook::AsyncRetry::AsyncRetry(AsyncFunc func_, Context& context_, Continuation continuation_)
+    : func(std::move(func_)), context(context_), continuation(std::move(continuation_)),
+      request_start_time(Clock::now())
+{
+}
+
 RetryRequestHook::RetryRequestHook(const Parameters& parameters) : RequestHook("retry"), _parameters(parameters)
 {
 }
 
 Status RetryRequestHook::Process(Func func, Context& context)
 {
-  _request_start_time = Clock::now();
-  _retry_counter = 0;
-  _func = func;
-  return RequestHook::Process(func, context);
+  const TimePoint request_start_time = Clock::now();
+  uint32_t retry_counter = 0;
+
+  Status status = RequestHook::Process(func, context);
+  while (std::optional<RetryBackoffStrategy::Duration> retry_delay =
+             getRetryDelay(status, retry_counter, request_start_time))
+  {
+    std::this_thread::sleep_for(retry_delay.value());
+    status = RequestHook::Process(func, context);
+  }
+  return status;
+}
+
+void RetryRequestHook::ProcessAsync(AsyncFunc func, Context& context, Continuation continuation)
+{
+  attemptAsync(std::make_shared<AsyncRetry>(std::move(func), context, std::move(continuation)));
 }
 
-Status RetryRequestHook::post_process(Context& context, Status status)
+void RetryRequestHook::attemptAsync(const std::shared_ptr<AsyncRetry>& retry)
+{
+  RequestHook::ProcessAsync(retry->func, retry->context, [this, retry](Status status) {
+    std::optional<RetryBackoffStrategy::Duration> retry_delay =
+        getRetryDelay(status, retry->retry_counter, retry->request_start_time);
+    if (!retry_delay.has_value())
+    {
+      retry->continued = true;
+      retry->continuation(status);
+      return;
+    }
+
+    if (!_parameters.executor)
+    {
+      std::this_thread::sleep_for(retry_delay.value());
+      attemptAsync(retry);
+      return;
+    }
+
+    _parameters.executor->PostAfter(retry_delay.value(), [this, retry]() {
+      try
+      {
+        attemptAsync(retry);
+      }
+      catch (...)
+      {
+        if (retry->continued)
+        {
+          throw;
+        }
+        // there is no caller anymore that could handle the exception
+        retry->continuation(mse::Status{mse::StatusCode::internal, "exception during retry"});
+      }
+    });
+  });
+}
+
+std::optional<RetryBackoffStrategy::Duration> RetryRequestHook::getRetryDelay(const Status& status,
+                                                                              uint32_t& retry_counter,
+                                                                              TimePoint request_start_time) const
 {
   if (_parameters.retry_error_codes.find(status.code) == _parameters.retry_error_codes.end())
   {
     // return code not found in retry codes  => no retry
-    return status;
+    return std::nullopt;
   }
 
   std::optional<RetryBackoffStrategy::Duration> duration_until_next_retry =
-      _parameters.backoff_strategy->GetDurationUntilNextRetry(++_retry_counter, Clock::now() - _request_start_time);
+      _parameters.backoff_strategy->GetDurationUntilNextRetry(++retry_counter, Clock::now() - request_start_time);
   if (!duration_until_next_retry.has_value())
   {
     MSE_LOG_TRACE(std::string("Retrying request failed with ") + to_string(status.code) + " after " +
-                  std::to_string(_retry_counter) + " retries. No further retry requested.");
-    return status;
+                  std::to_string(retry_counter) + " retries. No further retry requested.");
+    return std::nullopt;
   }
 
   MSE_LOG_TRACE(std::string("Request returned ") + to_string(status.code) + ". Retry #" +
-                std::to_string(_retry_counter) + " in " + std::to_string(duration_until_next_retry.value().count()) +
+                std::to_string(retry_counter) + " in " + std::to_string(duration_until_next_retry.value().count()) +
                 " ms.");
-
-  std::this_thread::sleep_for(duration_until_next_retry.value());
-  return RequestHook::Process(_func, context);
+  return duration_until_next_retry;
 }
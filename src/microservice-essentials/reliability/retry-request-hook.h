@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <microservice-essentials/request/request-hook-factory.h>
 #include <microservice-essentials/request/request-hook.h>
+#include <microservice-essentials/utilities/executor.h>
 #include <optional>
 #include <set>
 
@@ -76,6 +78,10 @@ private:
  * In case retries shall be performed in case of exceptions, consider using the ExceptionHandlingRequestHook to
  * convert an exception to a status code that results in retries.
  *
+ * The retry state is kept per call of Process, so a single hook can process concurrent requests.
+ *
+ * For asynchronously processed requests, the next attempt is scheduled on the executor given in the parameters, so that
+ * no thread is blocked while waiting. Without executor, the waiting blocks the thread that continued the request.
  */
 class RetryRequestHook : public mse::RequestHook
 {
@@ -90,8 +96,11 @@ public:
                                                             mse::StatusCode::resource_exhausted,
                                                             mse::StatusCode::internal, mse::StatusCode::unknown});
 
+    Parameters& WithExecutor(std::shared_ptr<Executor> executor_);
+
     std::shared_ptr<RetryBackoffStrategy> backoff_strategy;
     std::set<mse::StatusCode> retry_error_codes;
+    std::shared_ptr<Executor> executor; // used for waiting until the next retry of asynchronously processed requests
     AutoRequestHookParameterRegistration<RetryRequestHook::Parameters, RetryRequestHook> auto_registration;
   };
 
@@ -99,15 +108,26 @@ public:
   virtual ~RetryRequestHook() = default;
 
   virtual Status Process(Func func, Context& context) override;
-
-protected:
-  virtual Status post_process(Context& context, Status status) override;
+  virtual void ProcessAsync(AsyncFunc func, Context& context, Continuation continuation) override;
 
 private:
+  struct AsyncRetry
+  {
+    AsyncRetry(AsyncFunc func_, Context& context_, Continuation continuation_);
+
+    AsyncFunc func;
+    Context& context;
+    Continuation continuation;
+    TimePoint request_start_time;
+    uint32_t retry_counter = 0;
+    std::atomic<bool> continued = false;
+  };
+
+  void attemptAsync(const std::shared_ptr<AsyncRetry>& retry);
+  std::optional<RetryBackoffStrategy::Duration> getRetryDelay(const Status& status, uint32_t& retry_counter,
+                                                              TimePoint request_start_time) const;
+
   Parameters _parameters;
-  TimePoint _request_start_time;
-  uint32_t _retry_counter = 0;
-  Func _func;
 };
 
 } // namespace mse
@@ -1,4 +1,6 @@
 #include "request-hook.h"
+#include <atomic>
+#include <memory>
 #include <microservice-essentials/observability/logger.h>
 
 using namespace mse;
@@ -12,60 +14,62 @@ RequestHook::~RequestHook()
 }
 
 Status RequestHook::Process(Func func, Context& context)
+{
+  return ProcessInline(func, context);
+}
+
+void RequestHook::ProcessAsync(AsyncFunc func, Context& context, Continuation continuation)
 {
   MSE_LOG_TRACE(std::string("preprocessing by ") + _name);
 
   if (Status s = pre_process(context); !s)
   {
     MSE_LOG_TRACE(std::string("preprocessing failed with status ") + to_string(s.code) + " (" + s.details + ")");
-    return s;
+    continuation(s);
+    return;
   }
 
   MSE_LOG_TRACE(std::string("processing by ") + _name);
 
-  Status status = Status::OK;
+  // exceptions that are thrown after the function has continued are not related to this hook's processing
+  std::shared_ptr<std::atomic<bool>> continued = std::make_shared<std::atomic<bool>>(false);
   try
   {
-    status = func(context);
+    func(context, [this, &context, continuation, continued](Status status) {
+      *continued = true;
+      if (!status)
+      {
+        MSE_LOG_TRACE(std::string("processing failed with status ") + to_string(status.code) + " (" +
+                      status.details + ")");
+      }
+
+      MSE_LOG_TRACE(std::string("postprocessing by ") + _name);
+      status = post_process(context, status);
+      if (!status)
+      {
+        MSE_LOG_TRACE(std::string("postprocessing failed with status ") + to_string(status.code) + " (" +
+                      status.details + ")");
+      }
+
+      MSE_LOG_TRACE(std::string("completely processed by ") + _name);
+      continuation(status);
+    });
   }
-  catch (const std::exception& e)
+  catch (...)
   {
-    MSE_LOG_TRACE(std::string("postprocessing by ") + _name + " during exception: " + e.what());
-    status = post_process(context, mse::Status{mse::StatusCode::invalid, "exception during request"});
-    if (status.code == mse::StatusCode::invalid)
+    if (*continued)
     {
       throw;
     }
-    MSE_LOG_TRACE(std::string("completely processed by ") + _name + "after recovering from exception");
-    return status;
-  }
-  catch (...)
-  {
-    MSE_LOG_TRACE(std::string("postprocessing by ") + _name + " during unknown exception");
-    status = post_process(context, mse::Status{mse::StatusCode::invalid, "exception during request"});
+    MSE_LOG_TRACE(std::string("postprocessing by ") + _name + " during exception");
+    Status status = post_process(context, mse::Status{mse::StatusCode::invalid, "exception during request"});
     if (status.code == mse::StatusCode::invalid)
     {
       throw;
     }
     MSE_LOG_TRACE(std::string("completely processed by ") + _name + "after recovering from exception");
-    return status;
+    continuation(status);
   }
-
-  if (!status)
-  {
-    MSE_LOG_TRACE(std::string("processing failed with status ") + to_string(status.code) + " (" + status.details + ")");
-  }
-
-  MSE_LOG_TRACE(std::string("postprocessing by ") + _name);
-  status = post_process(context, status);
-  if (!status)
-  {
-    MSE_LOG_TRACE(std::string("postprocessing failed with status ") + to_string(status.code) + " (" + status.details +
-                  ")");
-  }
-
-  MSE_LOG_TRACE(std::string("completely processed by ") + _name);
-  return status;
 }
 
 Status RequestHook::pre_process(Context&)
@@ -14,11 +14,21 @@ namespace mse
  * to call pre_process before and post_process after the passed function is called. The funcion and post_process will
  * only be called if pre_process succeeds (status code ok). The default implementation of pre_process and post_process
  * is empty.
+ * ProcessInline provides the same behavior for any callable without wrapping it into a Func, which allows pipelines
+ * that know their hooks at compile time (see static-pipeline.h) to inline the complete call chain.
+ *
+ * ProcessAsync is the continuation based variant of Process for requests that shall not block the calling thread (see
+ * RequestProcessor::ProcessAsync). Instead of returning the status, the function and the hook pass it to a
+ * continuation, which may be called later from another thread. By default it also calls pre_process and post_process,
+ * so that hooks that only override those work with both variants. Hooks that override Process should also override
+ * ProcessAsync.
  */
 class RequestHook
 {
 public:
   typedef std::function<Status(Context& context)> Func;
+  typedef std::function<void(Status status)> Continuation;
+  typedef std::function<void(Context& context, Continuation continuation)> AsyncFunc;
 
   RequestHook(const std::string& name);
   virtual ~RequestHook();
@@ -34,6 +44,10 @@ public:
 
   virtual Status Process(Func func, Context& context);
 
+  template <typename F> Status ProcessInline(F&& func, Context& context);
+
+  virtual void ProcessAsync(AsyncFunc func, Context& context, Continuation continuation);
+
 protected:
   virtual Status pre_process(Context& context);
   virtual Status post_process(Context& context, Status status);
@@ -42,4 +56,6 @@ protected:
   RequestType _type = RequestType::invalid;
 };
 
-} // namespace mse
\ No newline at end of file
+} // namespace mse
+
+#include "request-hook.txx"
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "request-pipeline.h"
+#include <microservice-essentials/request/request-hook-factory.h>
+#include <optional>
+
+using namespace mse;
+
+RequestPipeline::RequestPipeline(const std::string& request_name, mse::RequestType request_type)
+    : _request_name(request_name), _request_type(request_type)
+{
+}
+
+RequestPipeline& RequestPipeline::With(std::unique_ptr<RequestHook>&& hook)
+{
+  hook->SetRequestType(_request_type);
+  _hooks.emplace_back(std::move(hook));
+  return *this;
+}
+
+RequestPipeline& RequestPipeline::With(const std::any& hook_construction_params)
+{
+  return With(RequestHookFactory::GetInstance().Create(hook_construction_params));
+}
+
+RequestPipeline& RequestPipeline::BeginWith(std::unique_ptr<RequestHook>&& hook)
+{
+  hook->SetRequestType(_request_type);
+  _hooks.emplace(_hooks.begin(), std::move(hook));
+  return *this;
+}
+
+RequestPipeline& RequestPipeline::BeginWith(const std::any& hook_construction_params)
+{
+  return BeginWith(RequestHookFactory::GetInstance().Create(hook_construction_params));
+}
+
+Status RequestPipeline::Process(const RequestHook::Func& func, mse::Context&& context) const
+{
+  std::optional<Context::ThreadLocalScope> thread_local_scope;
+  if (_request_type == RequestType::incoming)
+  {
+    // make given context available as the thread local context until the request has been processed
+    thread_local_scope.emplace(context);
+  }
+
+  mse::Context request_context(&context);
+  request_context.Insert(ContextKey::request, _request_name);
+  return process(Invocation{this, &func}, 0, request_context);
+}
+
+Status RequestPipeline::process(const Invocation& invocation, std::size_t hook_index, Context& context)
+{
+  if (hook_index == invocation.pipeline->_hooks.size())
+  {
+    return (*invocation.func)(context);
+  }
+
+  // the wrapper only captures two words, so no allocation is required to create the RequestHook::Func
+  const Invocation* invocation_ptr = &invocation;
+  const std::size_t next_hook_index = hook_index + 1;
+  return invocation.pipeline->_hooks[hook_index]->Process(
+      [invocation_ptr, next_hook_index](Context& next_context) -> Status {
+        return process(*invocation_ptr, next_hook_index, next_context);
+      },
+      context);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <any>
+#include <cstddef>
+#include <memory>
+#include <microservice-essentials/context.h>
+#include <microservice-essentials/request/request-hook.h>
+#include <microservice-essentials/request/request-type.h>
+#include <microservice-essentials/status.h>
+#include <string>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Hook pipeline for a single endpoint that is built once (e.g. at startup) and then processes many requests, also
+ * concurrently. In contrast to RequestProcessor, the hooks are only created once, so that the per request costs are
+ * reduced to the hook logic itself. Thus the hooks must be able to process concurrent requests, which holds for all
+ * hooks that are provided by this library (their state is either immutable configuration or shared and synchronized,
+ * e.g. a cache or a circuit breaker strategy).
+ *
+ * The hooks are called in the same order as for RequestProcessor. Use RequestHandler::BuildPipeline or
+ * RequestIssuer::BuildPipeline to include the globally registered hooks.
+ *
+ * Example:
+ *
+ * // at startup
+ * _my_request_pipeline = mse::RequestHandler::BuildPipeline("myRequest");
+ * _my_request_pipeline.With(B::Params({}));
+ *
+ * // in the handler method for the specific call "myRequest"
+ * _my_request_pipeline.Process([&](mse::Context& context) { return _api.MyRequest(); }, mse::Context(metadata));
+ */
+class RequestPipeline
+{
+public:
+  RequestPipeline(const std::string& request_name, mse::RequestType request_type);
+
+  RequestPipeline& With(std::unique_ptr<RequestHook>&& hook);
+  RequestPipeline& With(const std::any& hook_construction_params);
+
+  RequestPipeline& BeginWith(std::unique_ptr<RequestHook>&& hook);
+  RequestPipeline& BeginWith(const std::any& hook_construction_params);
+
+  /**
+   * Processes a single request with the given context. Can be called concurrently, but the pipeline must not be changed
+   * by With or BeginWith at the same time.
+   */
+  Status Process(const RequestHook::Func& func, mse::Context&& context) const;
+
+private:
+  struct Invocation
+  {
+    const RequestPipeline* pipeline;
+    const RequestHook::Func* func;
+  };
+
+  static Status process(const Invocation& invocation, std::size_t hook_index, Context& context);
+
+  std::vector<std::unique_ptr<RequestHook>> _hooks;
+  std::string _request_name;
+  mse::RequestType _request_type;
+};
+
+} // namespace mse
@@ -1,9 +1,49 @@
 #include "request-processor.h"
 #include <microservice-essentials/context.h>
+#include <atomic>
 #include <microservice-essentials/request/request-hook-factory.h>
 
 using namespace mse;
 
+namespace
+{
+
+// everything an asynchronously processed request needs until it is completed
+struct AsyncRequest
+{
+  // the context's ancestors (e.g. a handler's context installed by a ThreadLocalScope) might not outlive the request,
+  // so the context is flattened into a snapshot that the request owns
+  AsyncRequest(std::deque<std::unique_ptr<RequestHook>>&& hooks_, Context&& context_, const std::string& request_name)
+      : hooks(std::move(hooks_)), context(ContextSnapshot(context_)), request_context(&context)
+  {
+    request_context.Insert(ContextKey::request, request_name);
+  }
+
+  void Complete(const Status& status)
+  {
+    if (!completed.exchange(true))
+    {
+      promise.set_value(status);
+    }
+  }
+
+  void Fail(std::exception_ptr exception)
+  {
+    if (!completed.exchange(true))
+    {
+      promise.set_exception(exception);
+    }
+  }
+
+  std::deque<std::unique_ptr<RequestHook>> hooks;
+  Context context;
+  Context request_context;
+  std::promise<Status> promise;
+  std::atomic<bool> completed = false;
+};
+
+} // namespace
+
 RequestProcessor::RequestProcessor(const std::string& request_name, mse::RequestType request_type,
                                    mse::Context&& context)
     : _request_name(request_name), _request_type(request_type), _context(std::move(context))
@@ -45,10 +85,39 @@ Status RequestProcessor::Process(RequestHook::Func func)
   }
 
   // 2. execute all hooks and the func with a new context
-  mse::Context request_context({{"request", _request_name}}, &_context);
+  mse::Context request_context(&_context);
+  request_context.Insert(ContextKey::request, _request_name);
   return wrapper(request_context);
 }
 
+std::future<Status> RequestProcessor::ProcessAsync(RequestHook::AsyncFunc func)
+{
+  std::shared_ptr<AsyncRequest> request =
+      std::make_shared<AsyncRequest>(std::move(_hooks), std::move(_context), _request_name);
+  std::future<Status> result = request->promise.get_future();
+
+  // 1. create nested wrapper
+  RequestHook::AsyncFunc wrapper = func;
+  for (auto hook_cit = rbegin(request->hooks); hook_cit != rend(request->hooks); ++hook_cit)
+  {
+    RequestHook& hook = **hook_cit;
+    wrapper = [&hook, wrapper](mse::Context& context, RequestHook::Continuation continuation) {
+      hook.ProcessAsync(wrapper, context, continuation);
+    };
+  }
+
+  // 2. start all hooks and the func. The continuation keeps the request alive until it is completed
+  try
+  {
+    wrapper(request->request_context, [request](Status status) { request->Complete(status); });
+  }
+  catch (...)
+  {
+    request->Fail(std::current_exception());
+  }
+  return result;
+}
+
 RequestHandler::RequestHandler(const std::string& request_name, mse::Context&& context)
     : RequestProcessor(request_name, RequestType::incoming, std::move(context)),
       GlobalRequestHookConstructionHolder(*this)
@@ -57,18 +126,38 @@ RequestHandler::RequestHandler(const std::string& request_name, mse::Context&& c
 
 Status RequestHandler::Process(RequestHook::Func func)
 {
-  // make given context available as the thread local context
-  Context::GetThreadLocalContext() = _context;
+  // make given context available as the thread local context until the request has been processed
+  Context::ThreadLocalScope thread_local_scope(_context);
 
   return RequestProcessor::Process(func);
 }
 
+RequestPipeline RequestHandler::BuildPipeline(const std::string& request_name)
+{
+  RequestPipeline pipeline(request_name, RequestType::incoming);
+  for (const auto& params : _global_hook_construction_params)
+  {
+    pipeline.With(params);
+  }
+  return pipeline;
+}
+
 RequestIssuer::RequestIssuer(const std::string& request_name, mse::Context&& context)
     : RequestProcessor(request_name, RequestType::outgoing, std::move(context)),
       GlobalRequestHookConstructionHolder(*this)
 {
 }
 
+RequestPipeline RequestIssuer::BuildPipeline(const std::string& request_name)
+{
+  RequestPipeline pipeline(request_name, RequestType::outgoing);
+  for (const auto& params : _global_hook_construction_params)
+  {
+    pipeline.With(params);
+  }
+  return pipeline;
+}
+
 template <typename RequestProcessorType>
 GlobalRequestHookConstructionHolder<RequestProcessorType>::GlobalRequestHookConstructionHolder(
     RequestProcessorType& requestProcessor)
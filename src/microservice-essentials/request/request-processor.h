@@ -2,9 +2,11 @@
 
 #include <any>
 #include <deque>
+#include <future>
 #include <memory>
 #include <microservice-essentials/context.h>
 #include <microservice-essentials/request/request-hook.h>
+#include <microservice-essentials/request/request-pipeline.h>
 #include <microservice-essentials/request/request-type.h>
 #include <vector>
 
@@ -60,6 +62,16 @@ public:
 
   virtual Status Process(RequestHook::Func func);
 
+  /**
+   * Asynchronous variant of Process: func has to pass the status to the continuation instead of returning it, which may
+   * happen later and from another thread (see RequestHook::ProcessAsync). The returned future becomes ready as soon as
+   * all hooks have passed the status on. The hooks and the context are moved into the asynchronous request, i.e. the
+   * processor cannot be used afterwards. Unhandled exceptions that are thrown while starting the request are stored in
+   * the future. Note that the context is not installed as the thread local context. The request owns a snapshot of the
+   * context and its ancestors, so continuations may run after e.g. the ThreadLocalScope of a handler has ended.
+   */
+  std::future<Status> ProcessAsync(RequestHook::AsyncFunc func);
+
 protected:
   std::deque<std::unique_ptr<RequestHook>> _hooks;
   std::string _request_name;
@@ -85,15 +97,16 @@ public:
     _global_hook_construction_params.clear();
   }
 
-private:
+protected:
   static std::vector<std::any> _global_hook_construction_params;
 };
 
 /**
  * RequestProcessor for incoming request (i.e. this service handles those requests)
  * Allows to define hooks that shall be called for each incoming request.
- * Before calling the base class, the thread local context is set so that all code that is executed during request
- * handling is able to access the context without the need to pass it around explicitly.
+ * While the request is processed, the given context is installed as the thread local context (without copying it) so
+ * that all code that is executed during request handling is able to access the context without the need to pass it
+ * around explicitly. Afterwards, the previous thread local context is restored.
  */
 class RequestHandler : public RequestProcessor, public GlobalRequestHookConstructionHolder<RequestHandler>
 {
@@ -101,6 +114,11 @@ public:
   RequestHandler(const std::string& request_name, mse::Context&& context);
 
   virtual Status Process(RequestHook::Func func) override;
+
+  /**
+   * Builds a reusable pipeline for incoming requests that includes the globally registered hooks (see RequestPipeline).
+   */
+  static RequestPipeline BuildPipeline(const std::string& request_name);
 };
 
 /**
@@ -111,6 +129,11 @@ class RequestIssuer : public RequestProcessor, public GlobalRequestHookConstruct
 {
 public:
   RequestIssuer(const std::string& request_name, mse::Context&& context);
+
+  /**
+   * Builds a reusable pipeline for outgoing requests that includes the globally registered hooks (see RequestPipeline).
+   */
+  static RequestPipeline BuildPipeline(const std::string& request_name);
 };
 
 // explicit instantiation declaration to suppress warning
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <microservice-essentials/context.h>
+#include <microservice-essentials/request/request-hook.h>
+#include <microservice-essentials/request/request-type.h>
+#include <microservice-essentials/status.h>
+#include <string>
+#include <tuple>
+
+namespace mse
+{
+
+/**
+ * Alternative to RequestProcessor for requests whose hooks are known at compile time. The hooks are stored by value and
+ * the nested calls are resolved at compile time, so processing a request neither wraps the hooks into
+ * RequestHook::Func objects nor allocates memory for the pipeline itself. Hooks that override RequestHook::Process
+ * (e.g. ExceptionHandlingRequestHook) still receive a RequestHook::Func, which is small enough to avoid an allocation.
+ *
+ * The hooks are called in the order of the template arguments, i.e. the same as for RequestProcessor with hooks added
+ * by With. Globally registered hooks are not included.
+ *
+ * Example:
+ *
+ * mse::StaticPipeline<ExceptionHandlingRequestHook, LoggingRequestHook> pipeline(
+ *     "myRequest", mse::RequestType::incoming, mse::Context(), ExceptionHandlingRequestHook::Parameters(),
+ *     LoggingRequestHook::Parameters());
+ * pipeline.Process([&](mse::Context& context) { return _api.MyRequest(); });
+ *
+ * For incoming requests the pipeline's context is installed as the thread local context while a request is processed
+ * (see RequestHandler).
+ */
+template <typename... Hooks> class StaticPipeline
+{
+public:
+  StaticPipeline(const std::string& request_name, RequestType request_type, Context&& context,
+                 const typename Hooks::Parameters&... parameters);
+
+  template <typename F> Status Process(F&& func);
+
+  template <typename Hook> Hook& GetHook();
+
+private:
+  template <std::size_t I, typename F> Status process(F& func, Context& context);
+
+  std::tuple<Hooks...> _hooks;
+  std::string _request_name;
+  RequestType _request_type;
+  Context _context;
+};
+
+} // namespace mse
+
+#include "static-pipeline.txx"
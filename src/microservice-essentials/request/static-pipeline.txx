@@ -0,0 +1,63 @@
+#pragma once
+
+#include "static-pipeline.h"
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace mse
+{
+
+template <typename... Hooks>
+StaticPipeline<Hooks...>::StaticPipeline(const std::string& request_name, RequestType request_type, Context&& context,
+                                         const typename Hooks::Parameters&... parameters)
+    : _hooks(parameters...), _request_name(request_name), _request_type(request_type), _context(std::move(context))
+{
+  std::apply([request_type](auto&... hook) { (hook.SetRequestType(request_type), ...); }, _hooks);
+}
+
+template <typename... Hooks> template <typename F> Status StaticPipeline<Hooks...>::Process(F&& func)
+{
+  std::optional<Context::ThreadLocalScope> thread_local_scope;
+  if (_request_type == RequestType::incoming)
+  {
+    thread_local_scope.emplace(_context);
+  }
+
+  Context request_context(&_context);
+  request_context.Insert(ContextKey::request, _request_name);
+  return process<0>(func, request_context);
+}
+
+template <typename... Hooks> template <typename Hook> Hook& StaticPipeline<Hooks...>::GetHook()
+{
+  return std::get<Hook>(_hooks);
+}
+
+template <typename... Hooks>
+template <std::size_t I, typename F>
+Status StaticPipeline<Hooks...>::process(F& func, Context& context)
+{
+  if constexpr (I == sizeof...(Hooks))
+  {
+    return func(context);
+  }
+  else
+  {
+    auto& hook = std::get<I>(_hooks);
+    auto next = [this, &func](Context& next_context) -> Status { return process<I + 1>(func, next_context); };
+
+    using Hook = std::tuple_element_t<I, std::tuple<Hooks...>>;
+    if constexpr (std::is_same_v<decltype(&Hook::Process), decltype(&RequestHook::Process)>)
+    {
+      return hook.ProcessInline(next, context);
+    }
+    else
+    {
+      // the hook customizes Process, so it has to be called with a type erased function
+      return hook.Process(next, context);
+    }
+  }
+}
+
+} // namespace mse
@@ -40,18 +40,18 @@ ClaimCheckerRequestHook::Parameters ClaimCheckerRequestHook::ClaimInSpaceSeparat
 }
 
 ClaimCheckerRequestHook::ClaimCheckerRequestHook(const Parameters& parameters)
-    : mse::RequestHook("claim checker"), _params(parameters)
+    : mse::RequestHook("claim checker"), _params(parameters), _claim_key(_params.claim)
 {
 }
 
 Status ClaimCheckerRequestHook::pre_process(Context& context)
 {
-  if (!context.Contains(_params.claim))
+  if (!context.Contains(_claim_key))
   {
     return _params.fail_status;
   }
 
-  const std::string claim = context.At(_params.claim);
+  const std::string claim = context.At(_claim_key);
   if (!_params.checker(claim))
   {
     return _params.fail_status;
@@ -49,6 +49,7 @@ protected:
 
 private:
   Parameters _params;
+  ContextKey _claim_key;
 };
 
 } // namespace mse
@@ -21,7 +21,8 @@ Status TokenAuthRequestHook::pre_process(Context& context)
 
   if (!context.Contains(_token_metadata_key))
   {
-    return Status{StatusCode::unauthenticated, std::string("metadata key '") + _token_metadata_key + ("' is missing")};
+    return Status{StatusCode::unauthenticated,
+                  std::string("metadata key '") + _token_metadata_key.str() + ("' is missing")};
   }
   const std::string token = context.At(_token_metadata_key);
 
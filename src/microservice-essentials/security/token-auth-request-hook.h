@@ -34,7 +34,7 @@ protected:
 private:
   virtual Status pre_process(Context& context) override final;
 
-  std::string _token_metadata_key;
+  ContextKey _token_metadata_key;
   std::vector<std::string> _required_claims;
 };
 
@@ -0,0 +1,83 @@
+#include "executor.h"
+#include <algorithm>
+#include <exception>
+#include <microservice-essentials/observability/logger.h>
+#include <string>
+
+using namespace mse;
+
+bool ThreadPoolExecutor::ScheduledTask::operator>(const ScheduledTask& other) const
+{
+  return due_time != other.due_time ? due_time > other.due_time : sequence_number > other.sequence_number;
+}
+
+ThreadPoolExecutor::ThreadPoolExecutor(std::size_t thread_count)
+{
+  for (std::size_t i = 0; i < std::max<std::size_t>(thread_count, 1); ++i)
+  {
+    _threads.emplace_back([this]() { work(); });
+  }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+  {
+    std::lock_guard lock(_mutex);
+    _stop = true;
+  }
+  _condition.notify_all();
+  for (std::thread& thread : _threads)
+  {
+    thread.join();
+  }
+}
+
+void ThreadPoolExecutor::Post(Task task)
+{
+  PostAfter(Duration::zero(), std::move(task));
+}
+
+void ThreadPoolExecutor::PostAfter(Duration delay, Task task)
+{
+  {
+    std::lock_guard lock(_mutex);
+    _tasks.push(ScheduledTask{Clock::now() + std::chrono::duration_cast<Clock::duration>(delay),
+                              _next_sequence_number++, std::move(task)});
+  }
+  _condition.notify_one();
+}
+
+void ThreadPoolExecutor::work()
+{
+  std::unique_lock lock(_mutex);
+  while (!_stop)
+  {
+    if (_tasks.empty())
+    {
+      _condition.wait(lock);
+      continue;
+    }
+    if (const Clock::time_point due_time = _tasks.top().due_time; due_time > Clock::now())
+    {
+      _condition.wait_until(lock, due_time);
+      continue;
+    }
+
+    Task task = std::move(const_cast<ScheduledTask&>(_tasks.top()).task);
+    _tasks.pop();
+    lock.unlock();
+    try
+    {
+      task();
+    }
+    catch (const std::exception& e)
+    {
+      MSE_LOG_ERROR(std::string("executor task failed with exception: ") + e.what());
+    }
+    catch (...)
+    {
+      MSE_LOG_ERROR("executor task failed with unknown exception");
+    }
+    lock.lock();
+  }
+}
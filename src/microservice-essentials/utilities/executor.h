@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace mse
+{
+
+/**
+ * Interface for executing tasks asynchronously, either as soon as possible or after a delay.
+ * Used by asynchronously processed requests (see RequestProcessor::ProcessAsync) to continue requests without blocking
+ * a thread, e.g. to wait for the next retry of a RetryRequestHook.
+ */
+class Executor
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double, std::milli>;
+  using Task = std::function<void()>;
+
+  virtual ~Executor() = default;
+
+  virtual void Post(Task task) = 0;
+  virtual void PostAfter(Duration delay, Task task) = 0;
+};
+
+/**
+ * Executor that runs tasks on a fixed number of worker threads. Delayed tasks do not occupy a worker thread while
+ * waiting, so a few threads are able to drive a large number of in-flight requests.
+ * Exceptions thrown by tasks are caught and logged. Pending tasks are discarded on destruction.
+ */
+class ThreadPoolExecutor : public Executor
+{
+public:
+  ThreadPoolExecutor(std::size_t thread_count = std::thread::hardware_concurrency());
+  virtual ~ThreadPoolExecutor();
+
+  virtual void Post(Task task) override;
+  virtual void PostAfter(Duration delay, Task task) override;
+
+private:
+  struct ScheduledTask
+  {
+    Clock::time_point due_time;
+    std::size_t sequence_number; // keeps the order of tasks that are due at the same time
+    Task task;
+
+    bool operator>(const ScheduledTask& other) const;
+  };
+
+  void work();
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::priority_queue<ScheduledTask, std::vector<ScheduledTask>, std::greater<ScheduledTask>> _tasks;
+  std::size_t _next_sequence_number = 0;
+  bool _stop = false;
+  std::vector<std::thread> _threads;
+};
+
+} // namespace mse
@@ -24,6 +24,15 @@ inline Context::Metadata ToContextMetadata(const Container& external_metadata, b
  */
 template <typename Container> inline Container FromContextMetadata(const Context::Metadata& metadata);
 
+/**
+ * Converts the metadata of a context (including its parents) with the given keys to some container
+ * in contrast to FromContextMetadata(context.GetFilteredMetadata(keys)), no intermediate copy of the metadata is created
+ * the keys can be any container of strings or string views (e.g. std::vector<std::string_view>)
+ * works for e.g. propagating headers to an outgoing request via httplib::Headers
+ */
+template <typename Container, typename Keys = std::vector<std::string>>
+inline Container FromContextMetadata(const Context& context, const Keys& keys);
+
 /**
  * Exports metadata by calling some function that takes two strings for each metadata item
  * works for e.g. grpc::ClientContext::AddMetaData
@@ -20,8 +20,8 @@ inline Context::Metadata ToContextMetadata(const Container& external_metadata, b
       std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
     }
 
-    const std::string value(std::begin(key_value_pair.second), std::end(key_value_pair.second));
-    metadata.insert({key, value});
+    std::string value(std::begin(key_value_pair.second), std::end(key_value_pair.second));
+    metadata.emplace(std::move(key), std::move(value));
   }
   return metadata;
 }
@@ -36,6 +36,15 @@ template <typename Container> inline Container FromContextMetadata(const Context
   return external_metadata;
 }
 
+template <typename Container, typename Keys>
+inline Container FromContextMetadata(const Context& context, const Keys& keys)
+{
+  Container external_metadata;
+  context.VisitFilteredMetadata(
+      keys, [&](const std::string& key, const std::string& value) { external_metadata.insert({key, value}); });
+  return external_metadata;
+}
+
 template <typename ExportFunction>
 inline void ExportMetadata(const Context::Metadata& metadata, ExportFunction export_fn)
 {
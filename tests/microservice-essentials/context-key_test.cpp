@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+#include <microservice-essentials/context.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+SCENARIO("Context Key", "[context]")
+{
+  GIVEN("a well-known key")
+  {
+    const mse::ContextKey key = mse::ContextKey::trace_id;
+    THEN("it is indexed and refers to its string")
+    {
+      REQUIRE(key.IsIndexed());
+      REQUIRE(key.str() == "x-b3-traceid");
+      REQUIRE(mse::ContextKey::FindIndexed("x-b3-traceid") == key.GetId());
+    }
+  }
+
+  GIVEN("a custom key that is interned twice")
+  {
+    const mse::ContextKey key1("my-custom-context-key");
+    const mse::ContextKey key2(std::string("my-custom-context-key"));
+    THEN("both handles are identical")
+    {
+      REQUIRE(key1.GetId() == key2.GetId());
+      REQUIRE(key1.str() == "my-custom-context-key");
+    }
+  }
+
+  GIVEN("a custom key that is interned by several threads at once")
+  {
+    std::vector<mse::ContextKey::Id> ids(8, mse::ContextKey::invalid_id);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+      threads.emplace_back([&ids, i]() { ids[i] = mse::ContextKey("my-concurrently-interned-key").GetId(); });
+    }
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+    THEN("all threads get the same handle")
+    {
+      for (mse::ContextKey::Id id : ids)
+      {
+        REQUIRE(id == ids.front());
+      }
+      REQUIRE(ids.front() != mse::ContextKey::invalid_id);
+    }
+  }
+
+  GIVEN("a context with metadata that has been inserted by string")
+  {
+    mse::Context context({{"b", "y"}, {"request", "my_request"}, {"a", "x"}}, nullptr);
+    THEN("the metadata can be accessed by a handle")
+    {
+      REQUIRE(context.Contains(mse::ContextKey::request));
+      REQUIRE(context.At(mse::ContextKey::request) == "my_request");
+      REQUIRE(context.AtOr(mse::ContextKey::request, "default") == "my_request");
+      REQUIRE(context.Contains(mse::ContextKey::app) == false);
+      REQUIRE(context.AtOr(mse::ContextKey::app, "default") == "default");
+      REQUIRE_THROWS_AS(context.At(mse::ContextKey::app), std::out_of_range);
+    }
+
+    WHEN("entries before and after the key are inserted and erased")
+    {
+      context.Insert("0", "first");
+      context.Insert("z", "last");
+      context.Erase("a");
+      context.Insert(mse::ContextKey::request, "another_request");
+      THEN("the first entry of the key is still found")
+      {
+        REQUIRE(context.At(mse::ContextKey::request) == "my_request");
+      }
+
+      AND_WHEN("the first entry of the key is erased")
+      {
+        auto& metadata = context.GetMetadata();
+        metadata.erase(metadata.find("request"));
+        THEN("the next entry with the same key is found")
+        {
+          REQUIRE(context.At(mse::ContextKey::request) == "another_request");
+        }
+      }
+    }
+
+    WHEN("the key is erased")
+    {
+      context.Erase("request");
+      THEN("it cannot be found by its handle anymore")
+      {
+        REQUIRE(context.Contains(mse::ContextKey::request) == false);
+      }
+    }
+
+    WHEN("the context is copied")
+    {
+      const mse::Context copied_context = context;
+      THEN("the metadata can be accessed by a handle in the copy")
+      {
+        REQUIRE(copied_context.At(mse::ContextKey::request) == "my_request");
+      }
+    }
+  }
+
+  GIVEN("a key that is interned after the metadata has been inserted")
+  {
+    mse::Context context({{"key-interned-late", "value"}}, nullptr);
+    const mse::ContextKey key("key-interned-late");
+    THEN("the metadata can be accessed by its handle")
+    {
+      REQUIRE(context.At(key) == "value");
+    }
+  }
+
+  GIVEN("a child context of a parent with metadata")
+  {
+    mse::Context parent({{"app", "my_app"}}, nullptr);
+    mse::Context child(&parent);
+    THEN("the parent's metadata can be accessed by a handle")
+    {
+      REQUIRE(child.At(mse::ContextKey::app) == "my_app");
+    }
+  }
+}
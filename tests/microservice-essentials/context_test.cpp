@@ -2,9 +2,12 @@
 #include <catch2/catch_test_macros.hpp>
 #include <future>
 #include <iomanip>
+#include <memory>
 #include <microservice-essentials/context.h>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #ifdef _WIN32
@@ -127,6 +130,39 @@ SCENARIO("Context Metadata", "[context]")
   }
 }
 
+SCENARIO("Context Lookup by String View", "[context]")
+{
+  GIVEN("Context with metadata")
+  {
+    mse::Context context({{"a", "x"}, {"b", "y"}});
+    const std::string buffer = "a;b;c";
+    const std::string_view key_a = std::string_view(buffer).substr(0, 1);
+    const std::string_view key_c = std::string_view(buffer).substr(4, 1);
+    THEN("the metadata can be accessed by string views that are not null terminated")
+    {
+      REQUIRE(context.Contains(key_a));
+      REQUIRE(context.At(key_a) == "x");
+      REQUIRE(context.AtOr(key_c, "default") == "default");
+      REQUIRE_THROWS_AS(context.At(key_c), std::out_of_range);
+    }
+    AND_THEN("the metadata can be filtered by string views")
+    {
+      std::vector<std::string> visited;
+      context.VisitFilteredMetadata(std::vector<std::string_view>{key_a, key_c},
+                                    [&](const std::string& key, const std::string&) { visited.push_back(key); });
+      REQUIRE(visited == std::vector<std::string>{"a"});
+    }
+    WHEN("the metadata is erased by a string view")
+    {
+      REQUIRE(context.Erase(key_a) == 1);
+      THEN("it is not available anymore")
+      {
+        REQUIRE(context.Contains("a") == false);
+      }
+    }
+  }
+}
+
 SCENARIO("Context with Parent", "[context]")
 {
   GIVEN("A context with metadata")
@@ -225,6 +261,46 @@ SCENARIO("Context with Parent", "[context]")
   }
 }
 
+SCENARIO("Context Metadata Visitor", "[context]")
+{
+  GIVEN("a chain of contexts with partially overlapping metadata")
+  {
+    mse::Context grand_parent({{"a", "grand_parent"}, {"b", "grand_parent"}, {"c", "grand_parent"}}, nullptr);
+    mse::Context parent({{"b", "parent"}}, &grand_parent);
+    mse::Context child({{"c", "child"}, {"d", "child"}}, &parent);
+
+    WHEN("all metadata is visited")
+    {
+      std::vector<std::pair<std::string, std::string>> visited;
+      child.VisitAllMetadata(
+          [&](const std::string& key, const std::string& value) { visited.emplace_back(key, value); });
+      std::sort(visited.begin(), visited.end());
+      THEN("each key is visited once with the value of the closest context")
+      {
+        REQUIRE(visited.size() == 4);
+        REQUIRE(visited[0] == std::pair<std::string, std::string>("a", "grand_parent"));
+        REQUIRE(visited[1] == std::pair<std::string, std::string>("b", "parent"));
+        REQUIRE(visited[2] == std::pair<std::string, std::string>("c", "child"));
+        REQUIRE(visited[3] == std::pair<std::string, std::string>("d", "child"));
+      }
+    }
+
+    WHEN("filtered metadata is visited")
+    {
+      std::vector<std::pair<std::string, std::string>> visited;
+      child.VisitFilteredMetadata({"c", "b", "x"}, [&](const std::string& key, const std::string& value) {
+        visited.emplace_back(key, value);
+      });
+      THEN("only the requested keys that exist are visited in the requested order")
+      {
+        REQUIRE(visited.size() == 2);
+        REQUIRE(visited[0] == std::pair<std::string, std::string>("c", "child"));
+        REQUIRE(visited[1] == std::pair<std::string, std::string>("b", "parent"));
+      }
+    }
+  }
+}
+
 SCENARIO("Context Initialization", "[context]")
 {
   WHEN("a context is constructed from an initializer list")
@@ -259,6 +335,11 @@ SCENARIO("Context Initialization", "[context]")
     {
       REQUIRE(context.At("line") == std::to_string(context_line));
     }
+    AND_THEN("all source location metadata is available")
+    {
+      REQUIRE(context.GetMetadata().size() == 4);
+      REQUIRE(context.GetAllMetadata().count("line") == 1);
+    }
     AND_THEN("the metadata holds the timestamp in UTZ format")
     {
       REQUIRE(context.Contains("timestamp"));
@@ -447,4 +528,126 @@ SCENARIO("Context Parent", "[context]")
       }
     }
   }
-}
\ No newline at end of file
+}
+SCENARIO("Context Thread Local Scope", "[context]")
+{
+  GIVEN("a context with some metadata")
+  {
+    mse::Context context({{"scoped", "foo"}});
+    const mse::Context* original_thread_local_context = &mse::Context::GetThreadLocalContext();
+    WHEN("it is installed as the thread local context")
+    {
+      {
+        mse::Context::ThreadLocalScope scope(context);
+        THEN("it is the thread local context")
+        {
+          REQUIRE(&mse::Context::GetThreadLocalContext() == &context);
+          REQUIRE(mse::Context::GetThreadLocalContext().Contains("scoped"));
+        }
+        AND_THEN("contexts without parent refer to it")
+        {
+          mse::Context child;
+          REQUIRE(child.Contains("scoped"));
+        }
+        AND_WHEN("another context is installed in a nested scope")
+        {
+          mse::Context nested_context({{"nested", "bar"}});
+          {
+            mse::Context::ThreadLocalScope nested_scope(nested_context);
+            REQUIRE(mse::Context::GetThreadLocalContext().Contains("nested"));
+            REQUIRE(mse::Context::GetThreadLocalContext().Contains("scoped"));
+          }
+          THEN("the outer context is restored when leaving the nested scope")
+          {
+            REQUIRE(&mse::Context::GetThreadLocalContext() == &context);
+          }
+        }
+      }
+      THEN("the original thread local context is restored when leaving the scope")
+      {
+        REQUIRE(&mse::Context::GetThreadLocalContext() == original_thread_local_context);
+        REQUIRE(!mse::Context::GetThreadLocalContext().Contains("scoped"));
+      }
+    }
+
+    WHEN("a context has to outlive the scope and the scoped context")
+    {
+      std::unique_ptr<mse::Context> scoped_context = std::make_unique<mse::Context>(context);
+      std::optional<mse::Context> long_lived_context;
+      {
+        mse::Context::ThreadLocalScope scope(*scoped_context);
+        long_lived_context.emplace(mse::ContextSnapshot(mse::Context::GetThreadLocalContext()));
+      }
+      scoped_context.reset();
+      THEN("it is constructed with a snapshot of the thread local context as parent")
+      {
+        REQUIRE(long_lived_context->At("scoped") == "foo");
+      }
+    }
+  }
+}
+
+SCENARIO("Context Snapshot", "[context]")
+{
+  GIVEN("a chain of contexts with some metadata")
+  {
+    // the global context is the explicit parent, i.e. metadata left in the thread local context does not leak in
+    mse::Context parent({{"a", "parent"}, {"b", "parent"}}, &mse::Context::GetGlobalContext());
+    mse::Context child({{"b", "child"}}, &parent);
+    WHEN("a snapshot of the child is created")
+    {
+      const mse::ContextSnapshot snapshot(child);
+      THEN("the snapshot contains the metadata of the whole chain")
+      {
+        REQUIRE(snapshot->At("a") == "parent");
+        REQUIRE(snapshot->At("b") == "child");
+        REQUIRE(snapshot->GetMetadata().size() == 2);
+      }
+      AND_THEN("its parent is the global context")
+      {
+        mse::Context::GetGlobalContext().Insert("snapshot_global", "global");
+        REQUIRE(snapshot->At("snapshot_global") == "global");
+        mse::Context::GetGlobalContext().Erase("snapshot_global");
+      }
+
+      AND_WHEN("the original contexts are modified")
+      {
+        parent.Insert("c", "parent");
+        child.Erase("b");
+        THEN("the snapshot does not change")
+        {
+          REQUIRE(snapshot->Contains("c") == false);
+          REQUIRE(snapshot->At("b") == "child");
+        }
+      }
+
+      AND_WHEN("an overlay is created on top of a copy of the snapshot that has been destroyed")
+      {
+        std::optional<mse::ContextSnapshot> snapshot_copy = snapshot;
+        mse::Context overlay({{"c", "overlay"}, {"a", "overlay"}}, *snapshot_copy);
+        snapshot_copy.reset();
+        THEN("the overlay contains its own and the snapshot's metadata")
+        {
+          REQUIRE(overlay.At("a") == "overlay");
+          REQUIRE(overlay.At("b") == "child");
+          REQUIRE(overlay.At("c") == "overlay");
+        }
+        AND_THEN("a copy of the overlay contains the snapshot's metadata as well")
+        {
+          const mse::Context overlay_copy = overlay;
+          REQUIRE(overlay_copy.At("b") == "child");
+        }
+      }
+
+      AND_WHEN("the snapshot is used concurrently by multiple threads")
+      {
+        auto future = std::async([snapshot]() { return mse::Context({{"c", "thread"}}, snapshot).At("b"); });
+        THEN("each thread can access the metadata")
+        {
+          REQUIRE(future.get() == "child");
+          REQUIRE(mse::Context(snapshot).At("b") == "child");
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+#include <microservice-essentials/flat-metadata.h>
+#include <string>
+#include <vector>
+
+SCENARIO("Flat Metadata", "[context][metadata]")
+{
+  GIVEN("empty metadata")
+  {
+    mse::FlatMetadata metadata;
+    THEN("it is empty")
+    {
+      REQUIRE(metadata.empty());
+      REQUIRE(metadata.size() == 0);
+      REQUIRE(metadata.begin() == metadata.end());
+      REQUIRE(metadata.find("a") == metadata.end());
+      REQUIRE(metadata.count("a") == 0);
+    }
+
+    WHEN("entries are inserted in random order")
+    {
+      metadata.insert({"c", "z"});
+      metadata.insert({{"a", "x"}, {"b", "y"}});
+      metadata.emplace("d", "w");
+      THEN("the entries can be found")
+      {
+        REQUIRE(metadata.size() == 4);
+        REQUIRE(metadata.find("a")->second == "x");
+        REQUIRE(metadata.find("b")->second == "y");
+        REQUIRE(metadata.find("c")->second == "z");
+        REQUIRE(metadata.find("d")->second == "w");
+      }
+      AND_THEN("the entries are sorted by key")
+      {
+        std::vector<std::string> keys;
+        for (const auto& entry : metadata)
+        {
+          keys.push_back(entry.first);
+        }
+        REQUIRE(keys == std::vector<std::string>{"a", "b", "c", "d"});
+      }
+
+      AND_WHEN("an entry is erased")
+      {
+        const auto erase_count = metadata.erase("b");
+        THEN("only that entry is gone")
+        {
+          REQUIRE(erase_count == 1);
+          REQUIRE(metadata.size() == 3);
+          REQUIRE(metadata.find("b") == metadata.end());
+          REQUIRE(metadata.find("c")->second == "z");
+        }
+      }
+
+      AND_WHEN("the metadata is cleared")
+      {
+        metadata.clear();
+        THEN("it is empty")
+        {
+          REQUIRE(metadata.empty());
+        }
+      }
+    }
+
+    WHEN("the same key is inserted multiple times")
+    {
+      metadata.insert({{"a", "first"}, {"b", "y"}, {"a", "second"}});
+      metadata.insert({"a", "third"});
+      THEN("all entries are kept in insertion order")
+      {
+        REQUIRE(metadata.count("a") == 3);
+        const auto [first, last] = metadata.equal_range("a");
+        std::vector<std::string> values;
+        for (auto cit = first; cit != last; ++cit)
+        {
+          values.push_back(cit->second);
+        }
+        REQUIRE(values == std::vector<std::string>{"first", "second", "third"});
+      }
+      AND_THEN("the first inserted entry is found")
+      {
+        REQUIRE(metadata.find("a")->second == "first");
+      }
+      AND_WHEN("the key is erased")
+      {
+        const auto erase_count = metadata.erase("a");
+        THEN("all entries with that key are erased")
+        {
+          REQUIRE(erase_count == 3);
+          REQUIRE(metadata.size() == 1);
+        }
+      }
+    }
+  }
+
+  GIVEN("metadata with more entries than the inline capacity")
+  {
+    mse::FlatMetadata metadata;
+    const std::size_t entry_count = 3 * mse::FlatMetadata::inline_capacity;
+    for (std::size_t i = 0; i < entry_count; ++i)
+    {
+      metadata.emplace("key_" + std::to_string(i), "a value that does not fit into the small string buffer");
+    }
+    THEN("all entries are available")
+    {
+      REQUIRE(metadata.size() == entry_count);
+      for (std::size_t i = 0; i < entry_count; ++i)
+      {
+        REQUIRE(metadata.count("key_" + std::to_string(i)) == 1);
+      }
+    }
+
+    WHEN("it is copied")
+    {
+      mse::FlatMetadata copy = metadata;
+      THEN("both are equal")
+      {
+        REQUIRE(copy == metadata);
+      }
+      AND_WHEN("the original is modified")
+      {
+        metadata.erase("key_0");
+        THEN("the copy is unaffected")
+        {
+          REQUIRE(copy != metadata);
+          REQUIRE(copy.size() == entry_count);
+        }
+      }
+    }
+
+    WHEN("it is moved")
+    {
+      const mse::FlatMetadata copy = metadata;
+      mse::FlatMetadata moved = std::move(metadata);
+      THEN("the target holds all entries")
+      {
+        REQUIRE(moved == copy);
+      }
+      AND_THEN("the source is empty")
+      {
+        REQUIRE(metadata.empty());
+      }
+    }
+  }
+}
@@ -149,6 +149,49 @@ SCENARIO("LogProvider", "[observability][logging]")
   }
 }
 
+SCENARIO("Logging Macros", "[observability][logging]")
+{
+  GIVEN("a registered test logger with info as min log level")
+  {
+    TestLogger logger(mse::LogLevel::info, true);
+    int message_constructions = 0;
+    const auto make_message = [&](const std::string& message) {
+      ++message_constructions;
+      return message;
+    };
+
+    WHEN("a message with info level is logged")
+    {
+      MSE_LOG_INFO(make_message("my info message"));
+      THEN("the message is written")
+      {
+        REQUIRE(message_constructions == 1);
+        REQUIRE(logger._last_message == "my info message");
+        REQUIRE(logger._last_level == mse::LogLevel::info);
+      }
+    }
+
+    WHEN("a message with trace level is logged")
+    {
+      MSE_LOG_TRACE(make_message("my trace message"));
+      THEN("the message is not even constructed")
+      {
+        REQUIRE(message_constructions == 0);
+        REQUIRE(logger._last_message == "");
+      }
+    }
+
+    WHEN("a message is logged without a trailing semicolon, as before the log level check")
+    {
+      MSE_LOG_WARN(make_message("my warn message"))
+      THEN("the message is written")
+      {
+        REQUIRE(logger._last_message == "my warn message");
+      }
+    }
+  }
+}
+
 SCENARIO("LogLevel", "[observability][logging]")
 {
   const std::vector<std::string> log_levels = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "CRITICAL"}; // increasing
@@ -310,6 +353,17 @@ SCENARIO("DiscardLogger", "[observability][logging]")
 
 SCENARIO("StructuredLogger", "[observability][logging]")
 {
+  GIVEN("a structured logger with a TestLogger backend with info as min log level")
+  {
+    TestLogger test_logger(mse::LogLevel::info);
+    mse::StructuredLogger structured_logger(test_logger, {"message"});
+    THEN("the structured logger is only enabled for levels that the backend writes")
+    {
+      REQUIRE(structured_logger.IsEnabled(mse::LogLevel::info));
+      REQUIRE(structured_logger.IsEnabled(mse::LogLevel::debug) == false);
+    }
+  }
+
   GIVEN("a structured logger with a TestLogger backend")
   {
     TestLogger test_logger;
@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+#include <microservice-essentials/performance/batch-caching-request-hook.h>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+class CountingCache : public mse::UnorderedMapCache
+{
+public:
+  virtual std::vector<std::shared_ptr<const Element>> GetMany(const std::vector<std::string>& keys) const override
+  {
+    ++get_many_count;
+    return mse::UnorderedMapCache::GetMany(keys);
+  }
+  virtual void InsertMany(const std::vector<std::pair<std::string, Element>>& elements) override
+  {
+    ++insert_many_count;
+    mse::UnorderedMapCache::InsertMany(elements);
+  }
+
+  mutable std::size_t get_many_count = 0;
+  std::size_t insert_many_count = 0;
+};
+} // namespace
+
+SCENARIO("Batch Caching Request Hook", "[performance][caching][request-hook]")
+{
+  GIVEN("a batch caching request hook for the statuses of three ships, one of which is cached")
+  {
+    std::shared_ptr<CountingCache> cache = std::make_shared<CountingCache>();
+    cache->Insert("2", mse::Cache::Element{std::string("cached"), mse::Status::OK, mse::Cache::Clock::now()});
+    const std::vector<std::string> ids = {"1", "2", "3"};
+    std::vector<std::optional<std::string>> statuses(ids.size());
+    std::vector<std::size_t> missing_indices;
+    mse::CachingRequestHook::Parameters::Duration max_age = 1h;
+    auto create_hook = [&]() {
+      return mse::BatchCachingRequestHook(mse::BatchCachingRequestHook::Parameters(cache)
+                                              .WithKeys(ids)
+                                              .WithCachedObjects(statuses)
+                                              .WithMissingIndices(missing_indices)
+                                              .WithMaxAge(max_age));
+    };
+    mse::Context context;
+    int call_count = 0;
+    mse::StatusCode status_code = mse::StatusCode::ok;
+    auto func = [&](mse::Context&) {
+      ++call_count;
+      for (std::size_t index : missing_indices)
+      {
+        if (ids[index] != "3") // not found
+        {
+          statuses[index] = "fetched " + ids[index];
+        }
+      }
+      return mse::Status{status_code, ""};
+    };
+
+    WHEN("the request is processed")
+    {
+      const mse::Status status = create_hook().Process(func, context);
+      THEN("the function is executed once for the missing items only")
+      {
+        REQUIRE(status.code == mse::StatusCode::ok);
+        REQUIRE(call_count == 1);
+        REQUIRE(missing_indices == std::vector<std::size_t>{0, 2});
+        REQUIRE(statuses[0] == "fetched 1");
+        REQUIRE(statuses[1] == "cached");
+        REQUIRE(!statuses[2].has_value());
+        REQUIRE(cache->get_many_count == 1);
+        REQUIRE(cache->insert_many_count == 1);
+      }
+      AND_THEN("the fetched items are cached, but not those without a value")
+      {
+        REQUIRE(std::any_cast<std::string>(cache->Get("1").data) == "fetched 1");
+        REQUIRE(cache->GetShared("3") == nullptr);
+      }
+      AND_WHEN("the request is processed again")
+      {
+        statuses.assign(ids.size(), std::nullopt);
+        create_hook().Process(func, context);
+        THEN("only the item that was not found is requested again")
+        {
+          REQUIRE(call_count == 2);
+          REQUIRE(missing_indices == std::vector<std::size_t>{2});
+          REQUIRE(statuses[0] == "fetched 1");
+          REQUIRE(statuses[1] == "cached");
+        }
+      }
+    }
+
+    WHEN("all items are cached")
+    {
+      cache->Insert("1", mse::Cache::Element{std::string("cached"), mse::Status::OK, mse::Cache::Clock::now()});
+      cache->Insert("3", mse::Cache::Element{std::string("cached"), mse::Status::OK, mse::Cache::Clock::now()});
+      const mse::Status status = create_hook().Process(func, context);
+      THEN("the function is not executed")
+      {
+        REQUIRE(status.code == mse::StatusCode::ok);
+        REQUIRE(call_count == 0);
+        REQUIRE(statuses == std::vector<std::optional<std::string>>{"cached", "cached", "cached"});
+      }
+    }
+
+    WHEN("the cached item is older than the max age")
+    {
+      max_age = 1ms;
+      std::this_thread::sleep_for(5ms);
+      create_hook().Process(func, context);
+      THEN("it is requested again")
+      {
+        REQUIRE(missing_indices == std::vector<std::size_t>{0, 1, 2});
+        REQUIRE(std::any_cast<std::string>(cache->Get("2").data) == "fetched 2");
+      }
+    }
+
+    WHEN("the function fails")
+    {
+      status_code = mse::StatusCode::unavailable;
+      const mse::Status status = create_hook().Process(func, context);
+      THEN("its status is returned and nothing is cached")
+      {
+        REQUIRE(status.code == mse::StatusCode::unavailable);
+        REQUIRE(cache->insert_many_count == 0);
+      }
+    }
+
+    WHEN("the request is processed asynchronously")
+    {
+      mse::RequestHook::Continuation pending_continuation;
+      std::optional<mse::Status> result;
+      mse::BatchCachingRequestHook hook = create_hook();
+      hook.ProcessAsync(
+          [&](mse::Context& context, mse::RequestHook::Continuation continuation) {
+            func(context);
+            pending_continuation = continuation;
+          },
+          context, [&result](mse::Status status) { result = status; });
+      REQUIRE(!result.has_value());
+      pending_continuation(mse::Status::OK);
+      THEN("the fetched items are cached when the function completes")
+      {
+        REQUIRE(result.has_value());
+        REQUIRE(std::any_cast<std::string>(cache->Get("1").data) == "fetched 1");
+      }
+    }
+  }
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch_test_macros.hpp>
+#include <microservice-essentials/performance/cache-statistics.h>
+#include <microservice-essentials/performance/caching-request-hook.h>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+SCENARIO("Cache Statistics", "[performance][caching]")
+{
+  GIVEN("cache statistics")
+  {
+    mse::CacheStatistics statistics;
+
+    WHEN("nothing has been recorded")
+    {
+      const mse::CacheStatistics::Snapshot snapshot = statistics.GetSnapshot();
+      THEN("all counters are zero")
+      {
+        REQUIRE(snapshot.hits == 0);
+        REQUIRE(snapshot.misses == 0);
+        REQUIRE(snapshot.HitRatio() == 0.0);
+        REQUIRE(snapshot.size == 0);
+      }
+    }
+
+    WHEN("hits and misses are recorded concurrently")
+    {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t)
+      {
+        threads.emplace_back([&statistics]() {
+          for (int i = 0; i < 1000; ++i)
+          {
+            if (i % 4 == 0)
+            {
+              statistics.RecordMiss();
+            }
+            else
+            {
+              statistics.RecordHit();
+            }
+          }
+        });
+      }
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+      const mse::CacheStatistics::Snapshot snapshot = statistics.GetSnapshot();
+      THEN("no record is lost")
+      {
+        REQUIRE(snapshot.hits == 3000);
+        REQUIRE(snapshot.misses == 1000);
+        REQUIRE(snapshot.HitRatio() == 0.75);
+      }
+    }
+
+    WHEN("load times are recorded")
+    {
+      statistics.RecordLoadTime(0.5ms);
+      statistics.RecordLoadTime(1ms);
+      statistics.RecordLoadTime(3ms);
+      statistics.RecordLoadTime(1h);
+      const mse::CacheStatistics::Snapshot snapshot = statistics.GetSnapshot();
+      THEN("they are counted in the buckets of their power of two")
+      {
+        REQUIRE(snapshot.load_time_histogram[0] == 1);
+        REQUIRE(snapshot.load_time_histogram[1] == 1);
+        REQUIRE(snapshot.load_time_histogram[2] == 1);
+        REQUIRE(snapshot.load_time_histogram[mse::CacheStatistics::LoadTimeBucketCount - 1] == 1);
+      }
+      AND_THEN("the snapshot can be converted to a string")
+      {
+        REQUIRE(mse::to_string(snapshot) == "hits: 0, misses: 0, hit ratio: 0, expirations: 0, evictions: 0, "
+                                            "inserts: 0, size: 0, load times: <1ms: 1 <2ms: 1 <4ms: 1 >=16384ms: 1");
+      }
+    }
+
+    WHEN("logging is started twice")
+    {
+      statistics.StartLogging("test", 1h);
+      THEN("an exception is thrown")
+      {
+        REQUIRE_THROWS_AS(statistics.StartLogging("test", 1h), std::logic_error);
+      }
+    }
+  }
+}
+
+SCENARIO("Cache Statistics of caches and hooks", "[performance][caching]")
+{
+  GIVEN("an unordered map cache with statistics")
+  {
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    mse::UnorderedMapCache cache(4, 1ms);
+    cache.SetStatistics(statistics);
+    REQUIRE(cache.GetStatistics() == statistics);
+
+    WHEN("elements are inserted, replaced, requested and removed")
+    {
+      cache.Insert("1", mse::Cache::Element{1, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Insert("2", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Insert("1", mse::Cache::Element{3, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Get("1");
+      cache.GetShared("2");
+      cache.Get("3");
+      cache.Remove("2");
+      cache.Remove("3");
+      const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+      THEN("all operations are counted")
+      {
+        REQUIRE(snapshot.inserts == 3);
+        REQUIRE(snapshot.hits == 2);
+        REQUIRE(snapshot.misses == 1);
+        REQUIRE(snapshot.size == 1);
+      }
+    }
+
+    WHEN("an element expires and is reclaimed")
+    {
+      cache.Insert("1", mse::Cache::Element{1, mse::Status::OK, mse::Cache::Clock::now(),
+                                            mse::Cache::Clock::now() + 1ms});
+      std::this_thread::sleep_for(5ms);
+      cache.ReclaimExpired();
+      const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+      THEN("the expiration is counted")
+      {
+        REQUIRE(snapshot.expirations == 1);
+        REQUIRE(snapshot.size == 0);
+      }
+    }
+  }
+
+  GIVEN("a LRU cache with statistics and a capacity of 2")
+  {
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    mse::LRUCache cache(std::make_shared<mse::UnorderedMapCache>(), 2);
+    cache.SetStatistics(statistics);
+
+    WHEN("more elements are inserted than fit")
+    {
+      for (int i = 0; i < 5; ++i)
+      {
+        cache.Insert(std::to_string(i), mse::Cache::Element{i, mse::Status::OK, mse::Cache::Clock::now()});
+      }
+      cache.Get("0");
+      cache.Get("4");
+      const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+      THEN("the evictions are counted")
+      {
+        REQUIRE(snapshot.inserts == 5);
+        REQUIRE(snapshot.evictions == 3);
+        REQUIRE(snapshot.size == 2);
+        REQUIRE(snapshot.hits == 1);
+        REQUIRE(snapshot.misses == 1);
+      }
+    }
+  }
+
+  GIVEN("a caching request hook with statistics")
+  {
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    int object = 0;
+    mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(std::make_shared<mse::UnorderedMapCache>())
+                                     .WithKey("1")
+                                     .WithCachedObject(object)
+                                     .WithStatistics(statistics));
+    mse::Context context;
+
+    WHEN("the same request is processed twice")
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        hook.Process(
+            [&object](mse::Context&) {
+              std::this_thread::sleep_for(3ms);
+              object = 42;
+              return mse::Status::OK;
+            },
+            context);
+      }
+      const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+      THEN("a miss with its load time and a hit are counted")
+      {
+        REQUIRE(snapshot.misses == 1);
+        REQUIRE(snapshot.hits == 1);
+        std::uint64_t load_count = 0;
+        for (std::size_t i = 2; i < mse::CacheStatistics::LoadTimeBucketCount; ++i) // at least 2ms
+        {
+          load_count += snapshot.load_time_histogram[i];
+        }
+        REQUIRE(load_count == 1);
+      }
+    }
+  }
+}
@@ -1,6 +1,11 @@
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
 #include <microservice-essentials/performance/caching-request-hook.h>
+#include <stdexcept>
 #include <thread>
+#include <utility>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -34,6 +39,29 @@ public:
   std::string keyToBeRemoved;
   mse::Cache::Element element;
 };
+
+class ManualExecutor : public mse::Executor
+{
+public:
+  virtual void Post(Task task) override
+  {
+    tasks.push_back(task);
+  }
+  virtual void PostAfter(Duration, Task task) override
+  {
+    tasks.push_back(task);
+  }
+  void RunAll()
+  {
+    for (Task& task : std::exchange(tasks, {}))
+    {
+      task();
+    }
+  }
+
+  std::vector<Task> tasks;
+};
+
 } // namespace
 
 SCENARIO("Caching Request Hook", "[performance][caching][request-hook]")
@@ -76,6 +104,16 @@ SCENARIO("Caching Request Hook", "[performance][caching][request-hook]")
           REQUIRE(cache->elementToBeInserted.insertion_time >= before);
           REQUIRE(std::any_cast<int>(cache->elementToBeInserted.data) == 42);
         }
+
+        THEN("the element expires after the max age")
+        {
+          REQUIRE(cache->elementToBeInserted.expiry_time - cache->elementToBeInserted.insertion_time == 5ms);
+        }
+
+        THEN("the element is weighed with the default weigher")
+        {
+          REQUIRE(cache->elementToBeInserted.weight == 1);
+        }
       }
       WHEN("process is called on a failing function that returns not_found")
       {
@@ -170,6 +208,677 @@ SCENARIO("Caching Request Hook", "[performance][caching][request-hook]")
   }
 }
 
+SCENARIO("Caching Request Hook with shared cached objects", "[performance][caching][request-hook]")
+{
+  GIVEN("a caching request hook that caches a shared object")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> cache = std::make_shared<mse::UnorderedMapCache>();
+    std::shared_ptr<const std::string> object;
+    mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache).WithKey("1").WithCachedObject(object));
+    mse::Context context;
+    hook.Process(
+        [&object](mse::Context&) {
+          object = std::make_shared<const std::string>("0123456789");
+          return mse::Status::OK;
+        },
+        context);
+    const std::shared_ptr<const std::string> cached_object = object;
+
+    WHEN("the object is requested again")
+    {
+      object.reset();
+      bool has_been_called = false;
+      hook.Process(
+          [&has_been_called](mse::Context&) {
+            has_been_called = true;
+            return mse::Status::OK;
+          },
+          context);
+
+      THEN("the cached object is shared instead of copied")
+      {
+        REQUIRE(has_been_called == false);
+        REQUIRE(object == cached_object);
+      }
+      AND_THEN("the element is weighed by the size of the shared string")
+      {
+        REQUIRE(cache->GetShared("1")->weight == 10);
+      }
+    }
+  }
+}
+
+SCENARIO("Caching Request Hook with weigher", "[performance][caching][request-hook]")
+{
+  GIVEN("an empty cache")
+  {
+    std::shared_ptr<DummyCache> cache = std::make_shared<DummyCache>();
+    std::string content;
+    mse::Context context;
+    auto func = [&content](mse::Context&) {
+      content = "0123456789";
+      return mse::Status::OK;
+    };
+
+    WHEN("a string is cached with the default weigher")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache).WithKey("1").WithCachedObject(content));
+      hook.Process(func, context);
+      THEN("the element weighs the string's size")
+      {
+        REQUIRE(cache->elementToBeInserted.weight == 10);
+      }
+    }
+    WHEN("a string is cached with a custom weigher")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKey("1")
+                                       .WithCachedObject(content)
+                                       .WithWeigher([](const std::any& data) {
+                                         return std::any_cast<std::string>(data).size() + sizeof(std::string);
+                                       }));
+      hook.Process(func, context);
+      THEN("the element is weighed by the custom weigher")
+      {
+        REQUIRE(cache->elementToBeInserted.weight == 10 + sizeof(std::string));
+      }
+    }
+  }
+}
+
+SCENARIO("Caching Request Hook with status code specific max ages", "[performance][caching][request-hook]")
+{
+  GIVEN("a caching request hook that caches unavailable responses briefly")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> cache = std::make_shared<mse::UnorderedMapCache>();
+    int object = 0;
+    mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                     .WithKey("ship")
+                                     .WithCachedObject(object)
+                                     .WithMaxAge(1h)
+                                     .WithMaxAge({mse::StatusCode::unavailable, mse::StatusCode::not_found}, 1ms)
+                                     .WithStaleWhileRevalidate(1h));
+    mse::Context context;
+    int call_count = 0;
+    mse::StatusCode status_code = mse::StatusCode::unavailable;
+    auto func = [&call_count, &status_code](mse::Context&) {
+      ++call_count;
+      return mse::Status{status_code, ""};
+    };
+
+    WHEN("the dependency is unavailable")
+    {
+      REQUIRE(hook.Process(func, context).code == mse::StatusCode::unavailable);
+      REQUIRE(hook.Process(func, context).code == mse::StatusCode::unavailable);
+      THEN("the error is cached with its own max age")
+      {
+        REQUIRE(call_count == 1);
+        const std::shared_ptr<const mse::Cache::Element> element = cache->GetShared("ship");
+        REQUIRE(element != nullptr);
+        REQUIRE(element->expiry_time - element->insertion_time == std::chrono::milliseconds(1));
+      }
+      AND_WHEN("its max age has passed and the dependency has recovered")
+      {
+        std::this_thread::sleep_for(5ms);
+        status_code = mse::StatusCode::ok;
+        THEN("the error is not served stale")
+        {
+          REQUIRE(hook.Process(func, context).code == mse::StatusCode::ok);
+          REQUIRE(call_count == 2);
+        }
+        AND_THEN("successful responses use the default max age")
+        {
+          hook.Process(func, context);
+          std::this_thread::sleep_for(5ms);
+          REQUIRE(hook.Process(func, context).code == mse::StatusCode::ok);
+          REQUIRE(call_count == 2);
+        }
+      }
+    }
+  }
+
+  GIVEN("a caching request hook with stale while revalidate that overrides the max age of successful responses")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> cache = std::make_shared<mse::UnorderedMapCache>();
+    std::shared_ptr<ManualExecutor> executor = std::make_shared<ManualExecutor>();
+    int object = 0;
+    mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                     .WithKey("ship")
+                                     .WithCachedObject(object)
+                                     .WithMaxAge(mse::StatusCode::ok, 1ms)
+                                     .WithStaleWhileRevalidate(1h)
+                                     .WithBackgroundRefresh([](std::any&) { return mse::Status::OK; }, executor));
+    mse::Context context;
+    int call_count = 0;
+    auto func = [&call_count](mse::Context&) {
+      ++call_count;
+      return mse::Status::OK;
+    };
+
+    WHEN("a successful response is older than its max age")
+    {
+      hook.Process(func, context);
+      std::this_thread::sleep_for(5ms);
+      THEN("it is still served stale and refreshed in the background, as only its max age is overridden")
+      {
+        const std::shared_ptr<const mse::Cache::Element> element = cache->GetShared("ship");
+        REQUIRE(element != nullptr);
+        REQUIRE(element->expiry_time - element->insertion_time > std::chrono::minutes(59));
+        REQUIRE(hook.Process(func, context).code == mse::StatusCode::ok);
+        REQUIRE(call_count == 1);
+        REQUIRE(executor->tasks.size() == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Caching Request Hook with composed keys", "[performance][caching][request-hook]")
+{
+  GIVEN("an empty cache")
+  {
+    std::shared_ptr<DummyCache> cache = std::make_shared<DummyCache>();
+    int object = 0;
+    mse::Context context;
+    auto func = [](mse::Context&) { return mse::Status::OK; };
+
+    WHEN("the key is composed from strings, characters and numbers")
+    {
+      const std::string resource = "starship";
+      std::int64_t id = -42;
+      const char format = 'j';
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKeyFrom(resource, id, "status", format, true)
+                                       .WithCachedObject(object));
+      hook.Process(func, context);
+      THEN("the parts are joined")
+      {
+        REQUIRE(cache->keyToBeInserted == "starship/-42/status/j/true");
+      }
+      AND_WHEN("a part changes")
+      {
+        id = 7;
+        hook.Process(func, context);
+        THEN("the key changes too")
+        {
+          REQUIRE(cache->keyToBeInserted == "starship/7/status/j/true");
+        }
+      }
+    }
+
+    WHEN("the parts contain the separator")
+    {
+      auto key_from = [&](const std::string& first, const std::string& second) {
+        mse::CachingRequestHook hook(
+            mse::CachingRequestHook::Parameters(cache).WithKeyFrom(first, second).WithCachedObject(object));
+        hook.Process(func, context);
+        return cache->keyToBeInserted;
+      };
+      THEN("it is escaped, so that keys of different parts do not collide")
+      {
+        REQUIRE(key_from("a/b", "c") == "a\\/b/c");
+        REQUIRE(key_from("a", "b/c") == "a/b\\/c");
+        REQUIRE(key_from("a\\", "b") != key_from("a", "\\b"));
+      }
+    }
+
+    WHEN("the key is set by a key generator field")
+    {
+      mse::CachingRequestHook::Parameters parameters(cache);
+      parameters.WithCachedObject(object).key_generator = []() { return std::string("generated"); };
+      mse::CachingRequestHook(parameters).Process(func, context);
+      THEN("the generated key is used")
+      {
+        REQUIRE(cache->keyToBeInserted == "generated");
+      }
+    }
+
+    WHEN("the key is written by a custom key writer")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKeyWriter([](std::string& key) { key.append("custom"); })
+                                       .WithCachedObject(object));
+      hook.Process(func, context);
+      THEN("the written key is used")
+      {
+        REQUIRE(cache->keyToBeInserted == "custom");
+      }
+    }
+
+    WHEN("a request is processed by a hook while another hook processes a request")
+    {
+      std::shared_ptr<DummyCache> inner_cache = std::make_shared<DummyCache>();
+      mse::CachingRequestHook inner_hook(mse::CachingRequestHook::Parameters(inner_cache)
+                                             .WithKey("inner key that does not fit into a small string")
+                                             .WithCachedObject(object));
+      inner_hook.Process(func, context); // the thread's outermost key buffer has grown
+      mse::CachingRequestHook outer_hook(
+          mse::CachingRequestHook::Parameters(cache).WithKey("outer").WithCachedObject(object));
+      outer_hook.Process([&inner_hook, &func](mse::Context& context) { return inner_hook.Process(func, context); },
+                         context);
+      THEN("each request keeps its own key")
+      {
+        REQUIRE(inner_cache->keyToBeInserted == "inner key that does not fit into a small string");
+        REQUIRE(cache->keyToBeInserted == "outer");
+      }
+    }
+  }
+}
+
+SCENARIO("Caching Request Hook with request coalescing", "[performance][caching][request-hook]")
+{
+  GIVEN("an empty cache and request hooks that coalesce requests")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> cache = std::make_shared<mse::UnorderedMapCache>();
+    auto create_parameters = [&cache](int& object, std::chrono::milliseconds wait_timeout) {
+      return mse::CachingRequestHook::Parameters(cache)
+          .WithKey("ship")
+          .WithCachedObject(object)
+          .WithRequestCoalescing(wait_timeout);
+    };
+    std::atomic<int> call_count = 0;
+    std::atomic<bool> first_call_started = false;
+
+    WHEN("concurrent requests for the same key miss the cache")
+    {
+      const int thread_count = 8;
+      std::vector<int> objects(thread_count, 0);
+      std::vector<mse::Status> statuses(thread_count);
+      std::vector<std::thread> threads;
+      for (int i = 0; i < thread_count; ++i)
+      {
+        threads.emplace_back([&, i]() {
+          mse::CachingRequestHook hook(create_parameters(objects[i], 10s));
+          mse::Context context;
+          statuses[i] = hook.Process(
+              [&, i](mse::Context&) {
+                ++call_count;
+                std::this_thread::sleep_for(100ms);
+                objects[i] = 42;
+                return mse::Status::OK;
+              },
+              context);
+        });
+      }
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+
+      THEN("the function is called only once and all requests are served from its result")
+      {
+        REQUIRE(call_count == 1);
+        for (int i = 0; i < thread_count; ++i)
+        {
+          REQUIRE(statuses[i]);
+          REQUIRE(objects[i] == 42);
+        }
+      }
+    }
+
+    WHEN("a request misses the cache while another request with a status code that is not cached is processed")
+    {
+      int first_object = 0;
+      int second_object = 0;
+      mse::Status first_status;
+      std::thread first_request([&]() {
+        mse::CachingRequestHook hook(create_parameters(first_object, 10s));
+        mse::Context context;
+        first_status = hook.Process(
+            [&](mse::Context&) {
+              ++call_count;
+              first_call_started = true;
+              std::this_thread::sleep_for(100ms);
+              return mse::Status{mse::StatusCode::not_found, "no such ship"};
+            },
+            context);
+      });
+      while (!first_call_started)
+      {
+        std::this_thread::yield();
+      }
+      mse::CachingRequestHook hook(create_parameters(second_object, 10s));
+      mse::Context context;
+      mse::Status second_status = hook.Process(
+          [&](mse::Context&) {
+            ++call_count;
+            return mse::Status::OK;
+          },
+          context);
+      first_request.join();
+
+      THEN("the waiting request is served with the status of the first request")
+      {
+        REQUIRE(call_count == 1);
+        REQUIRE(first_status.code == mse::StatusCode::not_found);
+        REQUIRE(second_status.code == mse::StatusCode::not_found);
+        REQUIRE(second_status.details == "no such ship");
+        REQUIRE(mse::Cache::IsValid(cache->Get("ship")) == false);
+      }
+    }
+
+    WHEN("a request misses the cache and the request it waits for takes longer than the wait timeout")
+    {
+      int first_object = 0;
+      int second_object = 0;
+      std::thread first_request([&]() {
+        mse::CachingRequestHook hook(create_parameters(first_object, 10s));
+        mse::Context context;
+        hook.Process(
+            [&](mse::Context&) {
+              ++call_count;
+              first_call_started = true;
+              std::this_thread::sleep_for(200ms);
+              return mse::Status::OK;
+            },
+            context);
+      });
+      while (!first_call_started)
+      {
+        std::this_thread::yield();
+      }
+      mse::CachingRequestHook hook(create_parameters(second_object, 10ms));
+      mse::Context context;
+      mse::Status second_status = hook.Process(
+          [&](mse::Context&) {
+            ++call_count;
+            second_object = 7;
+            return mse::Status::OK;
+          },
+          context);
+      const int call_count_after_second_request = call_count;
+      first_request.join();
+
+      THEN("the waiting request calls the function on its own")
+      {
+        REQUIRE(call_count_after_second_request == 2);
+        REQUIRE(second_status);
+        REQUIRE(second_object == 7);
+      }
+    }
+
+    WHEN("a request misses the cache and the request it waits for throws an exception")
+    {
+      int first_object = 0;
+      int second_object = 0;
+      bool has_thrown = false;
+      std::thread first_request([&]() {
+        mse::CachingRequestHook hook(create_parameters(first_object, 10s));
+        mse::Context context;
+        try
+        {
+          hook.Process(
+              [&](mse::Context&) -> mse::Status {
+                ++call_count;
+                first_call_started = true;
+                std::this_thread::sleep_for(50ms);
+                throw std::runtime_error("downstream failure");
+              },
+              context);
+        }
+        catch (const std::runtime_error&)
+        {
+          has_thrown = true;
+        }
+      });
+      while (!first_call_started)
+      {
+        std::this_thread::yield();
+      }
+      mse::CachingRequestHook hook(create_parameters(second_object, 10s));
+      mse::Context context;
+      mse::Status second_status = hook.Process(
+          [&](mse::Context&) {
+            ++call_count;
+            second_object = 7;
+            return mse::Status::OK;
+          },
+          context);
+      first_request.join();
+
+      THEN("the exception is propagated to the first request and the waiting request calls the function on its own")
+      {
+        REQUIRE(has_thrown);
+        REQUIRE(call_count == 2);
+        REQUIRE(second_status);
+        REQUIRE(second_object == 7);
+      }
+    }
+
+    WHEN("requests for the same key are processed asynchronously")
+    {
+      int first_object = 0;
+      int second_object = 0;
+      mse::CachingRequestHook first_hook(create_parameters(first_object, 10s));
+      mse::CachingRequestHook second_hook(create_parameters(second_object, 10s));
+      mse::Context first_context;
+      mse::Context second_context;
+      mse::RequestHook::Continuation first_func_continuation;
+      std::vector<mse::Status> statuses;
+      auto func = [&](mse::Context&, mse::RequestHook::Continuation continuation) {
+        ++call_count;
+        first_func_continuation = continuation;
+      };
+      first_hook.ProcessAsync(func, first_context, [&](mse::Status status) { statuses.push_back(status); });
+      second_hook.ProcessAsync(func, second_context, [&](mse::Status status) { statuses.push_back(status); });
+      REQUIRE(statuses.empty());
+      first_object = 42;
+      first_func_continuation(mse::Status::OK);
+
+      THEN("the function is called only once and both requests are completed with its result")
+      {
+        REQUIRE(call_count == 1);
+        REQUIRE(statuses.size() == 2);
+        REQUIRE(statuses[0]);
+        REQUIRE(statuses[1]);
+        REQUIRE(second_object == 42);
+      }
+    }
+  }
+}
+
+SCENARIO("Caching Request Hook with stale while revalidate and refresh ahead", "[performance][caching][request-hook]")
+{
+  GIVEN("a cache with an element that has been inserted 20ms ago")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> cache = std::make_shared<mse::UnorderedMapCache>();
+    cache->Insert("ship", mse::Cache::Element{91, mse::Status::OK, mse::Cache::Clock::now() - 20ms});
+    std::shared_ptr<ManualExecutor> executor = std::make_shared<ManualExecutor>();
+    int object = 0;
+    std::atomic<int> call_count = 0;
+    auto func = [&](mse::Context&) {
+      ++call_count;
+      object = 42;
+      return mse::Status::OK;
+    };
+    auto refresher = [](std::any& data) {
+      data = 77;
+      return mse::Status::OK;
+    };
+    mse::Context context;
+
+    WHEN("the element is requested after max age but within the stale duration with a background refresher")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKey("ship")
+                                       .WithCachedObject(object)
+                                       .WithMaxAge(10ms)
+                                       .WithStaleWhileRevalidate(10s)
+                                       .WithBackgroundRefresh(refresher, executor));
+      mse::Status status = hook.Process(func, context);
+
+      THEN("the stale element is served and a single refresh is scheduled")
+      {
+        REQUIRE(status);
+        REQUIRE(object == 91);
+        REQUIRE(call_count == 0);
+        REQUIRE(executor->tasks.size() == 1);
+      }
+      AND_WHEN("the element is requested again before the refresh has run")
+      {
+        hook.Process(func, context);
+
+        THEN("no further refresh is scheduled")
+        {
+          REQUIRE(object == 91);
+          REQUIRE(executor->tasks.size() == 1);
+        }
+      }
+      AND_WHEN("the refresh has run")
+      {
+        executor->RunAll();
+        hook.Process(func, context);
+
+        THEN("the refreshed element is served without another refresh")
+        {
+          REQUIRE(object == 77);
+          REQUIRE(call_count == 0);
+          REQUIRE(executor->tasks.empty());
+        }
+      }
+    }
+
+    WHEN("a background refresher is configured without executor")
+    {
+      THEN("the parameters are rejected, as the refresh would run on the request thread")
+      {
+        REQUIRE_THROWS_AS(mse::CachingRequestHook::Parameters(cache).WithBackgroundRefresh(refresher, nullptr),
+                          std::invalid_argument);
+      }
+    }
+
+    WHEN("a background refresher is set directly without executor")
+    {
+      mse::CachingRequestHook::Parameters parameters(cache);
+      parameters.refresher = refresher;
+      THEN("the hook rejects the parameters instead of dereferencing the missing executor later")
+      {
+        REQUIRE_THROWS_AS(mse::CachingRequestHook(parameters), std::invalid_argument);
+      }
+    }
+
+    WHEN("the background refresher throws")
+    {
+      int refresh_count = 0;
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKey("ship")
+                                       .WithCachedObject(object)
+                                       .WithMaxAge(10ms)
+                                       .WithStaleWhileRevalidate(10s)
+                                       .WithBackgroundRefresh(
+                                           [&refresh_count](std::any&) -> mse::Status {
+                                             ++refresh_count;
+                                             throw std::runtime_error("upstream failed");
+                                           },
+                                           executor));
+      hook.Process(func, context);
+      REQUIRE_NOTHROW(executor->RunAll());
+      hook.Process(func, context);
+      executor->RunAll();
+
+      THEN("the stale element is kept and the next request triggers another refresh")
+      {
+        REQUIRE(object == 91);
+        REQUIRE(call_count == 0);
+        REQUIRE(refresh_count == 2);
+        REQUIRE(std::any_cast<int>(cache->Get("ship").data) == 91);
+      }
+    }
+
+    WHEN("the element is requested after the stale duration")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKey("ship")
+                                       .WithCachedObject(object)
+                                       .WithMaxAge(5ms)
+                                       .WithStaleWhileRevalidate(5ms)
+                                       .WithBackgroundRefresh(refresher, executor));
+      hook.Process(func, context);
+
+      THEN("the function is called as for any expired element")
+      {
+        REQUIRE(call_count == 1);
+        REQUIRE(object == 42);
+        REQUIRE(executor->tasks.empty());
+      }
+    }
+
+    WHEN("a stale element is requested while another request without background refresher refreshes it")
+    {
+      mse::CachingRequestHook::Parameters parameters = mse::CachingRequestHook::Parameters(cache)
+                                                           .WithKey("ship")
+                                                           .WithMaxAge(10ms)
+                                                           .WithStaleWhileRevalidate(10s);
+      int first_object = 0;
+      std::atomic<bool> first_call_started = false;
+      std::thread first_request([&]() {
+        mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(parameters).WithCachedObject(first_object));
+        mse::Context first_context;
+        hook.Process(
+            [&](mse::Context&) {
+              ++call_count;
+              first_call_started = true;
+              std::this_thread::sleep_for(100ms);
+              first_object = 42;
+              return mse::Status::OK;
+            },
+            first_context);
+      });
+      while (!first_call_started)
+      {
+        std::this_thread::yield();
+      }
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(parameters).WithCachedObject(object));
+      hook.Process(func, context);
+      const int call_count_after_second_request = call_count;
+      first_request.join();
+
+      THEN("the first request refreshes the element and the second request is served the stale element")
+      {
+        REQUIRE(call_count_after_second_request == 1);
+        REQUIRE(object == 91);
+        REQUIRE(first_object == 42);
+        REQUIRE(std::any_cast<int>(cache->Get("ship").data) == 42);
+      }
+    }
+
+    WHEN("the element is requested after the refresh ahead fraction of max age")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKey("ship")
+                                       .WithCachedObject(object)
+                                       .WithMaxAge(10s)
+                                       .WithRefreshAhead(0.000001)
+                                       .WithBackgroundRefresh(refresher, executor));
+      hook.Process(func, context);
+      executor->RunAll();
+
+      THEN("the element is served and refreshed in the background")
+      {
+        REQUIRE(object == 91);
+        REQUIRE(call_count == 0);
+        REQUIRE(std::any_cast<int>(cache->Get("ship").data) == 77);
+      }
+    }
+
+    WHEN("the element is requested before the refresh ahead fraction of max age")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKey("ship")
+                                       .WithCachedObject(object)
+                                       .WithMaxAge(10s)
+                                       .WithRefreshAhead(0.5)
+                                       .WithBackgroundRefresh(refresher, executor));
+      hook.Process(func, context);
+
+      THEN("the element is served without a refresh")
+      {
+        REQUIRE(object == 91);
+        REQUIRE(executor->tasks.empty());
+      }
+    }
+  }
+}
+
 SCENARIO("Unorded Map Cache", "[performance][caching]")
 {
   GIVEN("a unordered map cache")
@@ -205,6 +914,221 @@ SCENARIO("Unorded Map Cache", "[performance][caching]")
         REQUIRE(mse::Cache::IsValid(element) == false);
       }
     }
+    WHEN("an element is inserted and retrieved twice with shared ownership")
+    {
+      cache.Insert("1", mse::Cache::Element{1, mse::Status::OK, mse::Cache::Clock::now()});
+      std::shared_ptr<const mse::Cache::Element> first = cache.GetShared("1");
+      std::shared_ptr<const mse::Cache::Element> second = cache.GetShared("1");
+      THEN("both refer to the same element without copying it")
+      {
+        REQUIRE(first != nullptr);
+        REQUIRE(first == second);
+        REQUIRE(std::any_cast<int>(first->data) == 1);
+      }
+      AND_WHEN("the element is replaced")
+      {
+        cache.Insert("1", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now()});
+        THEN("previously retrieved elements remain valid")
+        {
+          REQUIRE(std::any_cast<int>(first->data) == 1);
+          REQUIRE(std::any_cast<int>(cache.GetShared("1")->data) == 2);
+        }
+      }
+    }
+    WHEN("a non existing element is retrieved with shared ownership")
+    {
+      THEN("nullptr is returned")
+      {
+        REQUIRE(cache.GetShared("1") == nullptr);
+      }
+    }
+  }
+
+  GIVEN("a unordered map cache with an expiry resolution of 1ms")
+  {
+    mse::UnorderedMapCache cache(4, 1ms);
+    std::shared_ptr<int> data = std::make_shared<int>(1);
+    std::weak_ptr<int> weak_data = data;
+    cache.Insert("1", mse::Cache::Element{data, mse::Status::OK, mse::Cache::Clock::now(),
+                                          mse::Cache::Clock::now() + 5ms});
+    data.reset();
+
+    WHEN("the element is retrieved before its expiry time")
+    {
+      THEN("the element can be retrieved")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("1")) == true);
+      }
+    }
+    WHEN("the element is retrieved after its expiry time")
+    {
+      std::this_thread::sleep_for(10ms);
+      THEN("the element cannot be retrieved")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("1")) == false);
+        REQUIRE(cache.GetShared("1") == nullptr);
+      }
+    }
+    WHEN("other elements are inserted after its expiry time")
+    {
+      std::this_thread::sleep_for(10ms);
+      for (int i = 2; i < 100; ++i)
+      {
+        cache.Insert(std::to_string(i), mse::Cache::Element{i, mse::Status::OK, mse::Cache::Clock::now()});
+      }
+      THEN("the element has been reclaimed")
+      {
+        REQUIRE(weak_data.expired());
+      }
+    }
+    WHEN("expired elements are reclaimed explicitly")
+    {
+      std::this_thread::sleep_for(10ms);
+      cache.ReclaimExpired();
+      THEN("the element has been reclaimed")
+      {
+        REQUIRE(weak_data.expired());
+      }
+    }
+    WHEN("the element is replaced with an element with a later expiry time")
+    {
+      cache.Insert("1", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now(),
+                                            mse::Cache::Clock::now() + 10s});
+      std::this_thread::sleep_for(10ms);
+      cache.ReclaimExpired();
+      THEN("the replacing element is neither expired nor reclaimed")
+      {
+        REQUIRE(weak_data.expired());
+        REQUIRE(std::any_cast<int>(cache.Get("1").data) == 2);
+      }
+    }
+    WHEN("the background reclamation is started")
+    {
+      cache.StartBackgroundReclamation(1ms);
+      const auto deadline = mse::Cache::Clock::now() + 10s;
+      while (!weak_data.expired() && mse::Cache::Clock::now() < deadline)
+      {
+        std::this_thread::sleep_for(1ms);
+      }
+      THEN("the element is reclaimed without further access to the cache")
+      {
+        REQUIRE(weak_data.expired());
+        REQUIRE_THROWS_AS(cache.StartBackgroundReclamation(1ms), std::logic_error);
+      }
+    }
+  }
+
+  GIVEN("a unordered map cache with 3 shards")
+  {
+    mse::UnorderedMapCache cache(3);
+    WHEN("many elements are inserted and removed concurrently")
+    {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t)
+      {
+        threads.emplace_back([&cache, t]() {
+          for (int i = 0; i < 1000; ++i)
+          {
+            const std::string key = std::to_string(t) + "-" + std::to_string(i);
+            cache.Insert(key, mse::Cache::Element{i, mse::Status::OK, mse::Cache::Clock::now()});
+            if (i % 2 == 1)
+            {
+              cache.Remove(key);
+            }
+          }
+        });
+      }
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+      THEN("exactly the elements that have not been removed can be retrieved")
+      {
+        for (int t = 0; t < 4; ++t)
+        {
+          for (int i = 0; i < 1000; ++i)
+          {
+            const mse::Cache::Element element = cache.Get(std::to_string(t) + "-" + std::to_string(i));
+            REQUIRE(mse::Cache::IsValid(element) == (i % 2 == 0));
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN("a unordered map cache with 4 shards and statistics")
+  {
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    mse::UnorderedMapCache cache(4, 1ms);
+    cache.SetStatistics(statistics);
+
+    WHEN("a batch of elements is inserted and requested with keys of all shards")
+    {
+      std::vector<std::pair<std::string, mse::Cache::Element>> elements;
+      std::vector<std::string> keys;
+      for (int i = 0; i < 20; ++i)
+      {
+        elements.emplace_back(std::to_string(i), mse::Cache::Element{i, mse::Status::OK, mse::Cache::Clock::now()});
+        keys.push_back(std::to_string(i));
+      }
+      elements.emplace_back("0", mse::Cache::Element{100, mse::Status::OK, mse::Cache::Clock::now()}); // replaces 0
+      keys.push_back("missing");
+      cache.InsertMany(elements);
+      const std::vector<std::shared_ptr<const mse::Cache::Element>> found_elements = cache.GetMany(keys);
+
+      THEN("the elements are returned in the order of the keys")
+      {
+        REQUIRE(found_elements.size() == keys.size());
+        REQUIRE(std::any_cast<int>(found_elements[0]->data) == 100);
+        for (int i = 1; i < 20; ++i)
+        {
+          REQUIRE(std::any_cast<int>(found_elements[i]->data) == i);
+        }
+        REQUIRE(found_elements.back() == nullptr);
+      }
+      AND_THEN("the statistics are recorded")
+      {
+        const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+        REQUIRE(snapshot.inserts == 21);
+        REQUIRE(snapshot.size == 20);
+        REQUIRE(snapshot.hits == 20);
+        REQUIRE(snapshot.misses == 1);
+      }
+    }
+
+    WHEN("a batch contains an expired element")
+    {
+      cache.InsertMany({{"1", mse::Cache::Element{1, mse::Status::OK, mse::Cache::Clock::now(),
+                                                  mse::Cache::Clock::now() + 1ms}}});
+      std::this_thread::sleep_for(5ms);
+      THEN("it is not returned")
+      {
+        REQUIRE(cache.GetMany({"1"}).front() == nullptr);
+      }
+    }
+
+    WHEN("a batch is inserted after elements of all shards have expired")
+    {
+      std::vector<std::pair<std::string, mse::Cache::Element>> expiring_elements;
+      std::vector<std::pair<std::string, mse::Cache::Element>> elements;
+      for (int i = 0; i < 20; ++i)
+      {
+        expiring_elements.emplace_back("expiring/" + std::to_string(i),
+                                       mse::Cache::Element{i, mse::Status::OK, mse::Cache::Clock::now(),
+                                                           mse::Cache::Clock::now() + 1ms});
+        elements.emplace_back(std::to_string(i), mse::Cache::Element{i, mse::Status::OK, mse::Cache::Clock::now()});
+      }
+      cache.InsertMany(expiring_elements);
+      std::this_thread::sleep_for(5ms);
+      cache.InsertMany(elements);
+      THEN("each reclaimed element is counted once")
+      {
+        const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+        REQUIRE(snapshot.inserts == 40);
+        REQUIRE(snapshot.expirations == 20);
+        REQUIRE(snapshot.size == 20);
+      }
+    }
   }
 }
 
@@ -224,6 +1148,13 @@ SCENARIO("LRU Cache", "[performance][caching]")
         REQUIRE(element.status == mse::Status::OK);
         REQUIRE(std::any_cast<int>(element.data) == 1);
       }
+      AND_THEN("it is shared with the backend instead of being copied")
+      {
+        std::shared_ptr<const mse::Cache::Element> element = cache.GetShared("1");
+        REQUIRE(element != nullptr);
+        REQUIRE(element == realCache->GetShared("1"));
+        REQUIRE(element == cache.GetShared("1"));
+      }
 
       AND_WHEN("an element is removed")
       {
@@ -258,4 +1189,55 @@ SCENARIO("LRU Cache", "[performance][caching]")
       }
     }
   }
+
+  GIVEN("a LRU cache with a capacity of 3 elements and statistics, one element expires in the backend")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> realCache = std::make_shared<mse::UnorderedMapCache>(16, 1ms);
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    mse::LRUCache cache(realCache, 3);
+    cache.SetStatistics(statistics);
+    cache.Insert("1",
+                 mse::Cache::Element{1, mse::Status::OK, mse::Cache::Clock::now(), mse::Cache::Clock::now() + 1ms});
+    cache.Insert("2", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now()});
+    std::this_thread::sleep_for(5ms);
+
+    WHEN("the expired element is inserted again and another element evicts the least recently used one")
+    {
+      cache.Insert("1", mse::Cache::Element{11, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Insert("3", mse::Cache::Element{3, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Insert("4", mse::Cache::Element{4, mse::Status::OK, mse::Cache::Clock::now()});
+      THEN("the fresh element is kept, as its key has a single position in the LRU order")
+      {
+        REQUIRE(std::any_cast<int>(cache.Get("1").data) == 11);
+        REQUIRE(mse::Cache::IsValid(cache.Get("2")) == false);
+        REQUIRE(mse::Cache::IsValid(cache.Get("3")) == true);
+        REQUIRE(mse::Cache::IsValid(cache.Get("4")) == true);
+        REQUIRE(statistics->GetSnapshot().size == 3);
+      }
+    }
+
+    WHEN("the expired element is missed and two further elements are inserted")
+    {
+      cache.Get("1");
+      cache.Insert("3", mse::Cache::Element{3, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Insert("4", mse::Cache::Element{4, mse::Status::OK, mse::Cache::Clock::now()});
+      THEN("its key does not count against the capacity anymore")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("2")) == true);
+        REQUIRE(mse::Cache::IsValid(cache.Get("3")) == true);
+        REQUIRE(mse::Cache::IsValid(cache.Get("4")) == true);
+        REQUIRE(statistics->GetSnapshot().size == 3);
+        REQUIRE(statistics->GetSnapshot().evictions == 0);
+      }
+    }
+
+    WHEN("the expired element is removed")
+    {
+      cache.Remove("1");
+      THEN("its key is removed from the LRU order as well")
+      {
+        REQUIRE(statistics->GetSnapshot().size == 1);
+      }
+    }
+  }
 }
@@ -0,0 +1,228 @@
+#include <any>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <memory>
+#include <microservice-essentials/performance/clock-cache.h>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+mse::Cache::Element create_element(int value)
+{
+  return mse::Cache::Element{value, mse::Status::OK, mse::Cache::Clock::now()};
+}
+} // namespace
+
+SCENARIO("Clock Cache", "[performance][caching]")
+{
+  GIVEN("a clock cache with a capacity of 2 elements in a single shard")
+  {
+    mse::ClockCache cache(2, 1);
+    WHEN("an element is inserted")
+    {
+      cache.Insert("1", create_element(1));
+      THEN("the element can be retrieved")
+      {
+        auto element = cache.Get("1");
+        REQUIRE(mse::Cache::IsValid(element) == true);
+        REQUIRE(element.status == mse::Status::OK);
+        REQUIRE(std::any_cast<int>(element.data) == 1);
+        REQUIRE(cache.GetShared("1") == cache.GetShared("1"));
+      }
+
+      AND_WHEN("an element is removed")
+      {
+        cache.Remove("1");
+        THEN("the element cannot be retrieved")
+        {
+          REQUIRE(mse::Cache::IsValid(cache.Get("1")) == false);
+          REQUIRE(cache.GetShared("1") == nullptr);
+        }
+      }
+
+      AND_WHEN("the element is replaced")
+      {
+        cache.Insert("1", create_element(11));
+        THEN("the new element can be retrieved")
+        {
+          REQUIRE(std::any_cast<int>(cache.Get("1").data) == 11);
+        }
+      }
+    }
+    WHEN("a non existing element is removed")
+    {
+      cache.Remove("1");
+      THEN("the element cannot be retrieved")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("1")) == false);
+      }
+    }
+    WHEN("the cache is full")
+    {
+      cache.Insert("1", create_element(1));
+      cache.Insert("2", create_element(2));
+      cache.Get("1"); // 1 is referenced, 2 is not
+      cache.Insert("3", create_element(3));
+      THEN("an element that has not been referenced is evicted")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("1")) == true);
+        REQUIRE(mse::Cache::IsValid(cache.Get("2")) == false);
+        REQUIRE(mse::Cache::IsValid(cache.Get("3")) == true);
+      }
+    }
+    WHEN("the first of two elements is removed and two further elements are inserted")
+    {
+      cache.Insert("1", create_element(1));
+      cache.Insert("2", create_element(2));
+      cache.Remove("1");
+      cache.Insert("3", create_element(3));
+      cache.Insert("4", create_element(4));
+      THEN("the capacity is respected and the latest element can be retrieved")
+      {
+        const int valid_count = mse::Cache::IsValid(cache.Get("2")) + mse::Cache::IsValid(cache.Get("3")) +
+                                mse::Cache::IsValid(cache.Get("4"));
+        REQUIRE(valid_count == 2);
+        REQUIRE(std::any_cast<int>(cache.Get("4").data) == 4);
+      }
+    }
+  }
+
+  GIVEN("a clock cache with a capacity of 2 elements and statistics")
+  {
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    mse::ClockCache cache(2, 1);
+    cache.SetStatistics(statistics);
+    cache.Insert("1", create_element(1));
+    cache.Insert("2", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now(),
+                                          mse::Cache::Clock::now() + 1ms});
+    cache.Get("1");
+    cache.Get("2");
+    WHEN("an element expires")
+    {
+      std::this_thread::sleep_for(5ms);
+      THEN("it is not returned anymore")
+      {
+        REQUIRE(cache.GetShared("2") == nullptr);
+      }
+      AND_WHEN("another element is inserted")
+      {
+        cache.Insert("3", create_element(3));
+        THEN("the expired element is evicted even though it has been referenced")
+        {
+          REQUIRE(std::any_cast<int>(cache.Get("1").data) == 1);
+          REQUIRE(std::any_cast<int>(cache.Get("3").data) == 3);
+        }
+        AND_THEN("the statistics are recorded")
+        {
+          const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+          REQUIRE(snapshot.inserts == 3);
+          REQUIRE(snapshot.hits == 2);
+          REQUIRE(snapshot.expirations == 1);
+          REQUIRE(snapshot.evictions == 0);
+          REQUIRE(snapshot.size == 2);
+        }
+      }
+    }
+    WHEN("an element is evicted and another one removed")
+    {
+      cache.Insert("3", create_element(3));
+      cache.Remove("3");
+      THEN("the statistics are recorded")
+      {
+        const mse::CacheStatistics::Snapshot snapshot = statistics->GetSnapshot();
+        REQUIRE(snapshot.evictions + snapshot.expirations == 1); // "2" might have expired in the meantime
+        REQUIRE(snapshot.size == 1);
+      }
+    }
+  }
+
+  GIVEN("a clock cache with a capacity of 100 elements in 4 shards")
+  {
+    mse::ClockCache cache(100, 4);
+    WHEN("many elements are inserted and retrieved concurrently")
+    {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t)
+      {
+        threads.emplace_back([&cache, t]() {
+          for (int i = 0; i < 1000; ++i)
+          {
+            const std::string key = std::to_string((t * 1000 + i) % 300);
+            cache.Insert(key, create_element(i));
+            cache.Get(std::to_string(i % 10));
+          }
+        });
+      }
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+      THEN("the cache holds at most its capacity")
+      {
+        int valid_count = 0;
+        for (int i = 0; i < 300; ++i)
+        {
+          valid_count += mse::Cache::IsValid(cache.Get(std::to_string(i)));
+        }
+        REQUIRE(valid_count > 0);
+        REQUIRE(valid_count <= 100);
+      }
+    }
+
+    WHEN("elements are read concurrently while they are replaced, evicted and removed")
+    {
+      std::atomic<bool> stop = false;
+      std::atomic<int> inconsistent_count = 0;
+      std::vector<std::thread> readers;
+      for (int t = 0; t < 4; ++t)
+      {
+        readers.emplace_back([&cache, &stop, &inconsistent_count]() {
+          for (int i = 0; !stop.load(); i = (i + 1) % 300)
+          {
+            if (std::shared_ptr<const mse::Cache::Element> element = cache.GetShared(std::to_string(i));
+                element != nullptr && std::any_cast<int>(element->data) % 300 != i)
+            {
+              ++inconsistent_count;
+            }
+          }
+        });
+      }
+      std::vector<std::thread> writers;
+      for (int t = 0; t < 2; ++t)
+      {
+        writers.emplace_back([&cache, t]() {
+          for (int i = 0; i < 20000; ++i)
+          {
+            const int key = (t * 7 + i) % 300;
+            if (i % 5 == 0)
+            {
+              cache.Remove(std::to_string(key));
+            }
+            else
+            {
+              cache.Insert(std::to_string(key), create_element(key + 300 * i));
+            }
+          }
+        });
+      }
+      for (std::thread& writer : writers)
+      {
+        writer.join();
+      }
+      stop = true;
+      for (std::thread& reader : readers)
+      {
+        reader.join();
+      }
+      THEN("readers only see the elements that belong to their keys")
+      {
+        REQUIRE(inconsistent_count == 0);
+        REQUIRE(cache.Peek("299") == cache.GetShared("299"));
+      }
+    }
+  }
+}
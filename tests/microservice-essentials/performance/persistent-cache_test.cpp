@@ -0,0 +1,198 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <fstream>
+#include <microservice-essentials/performance/persistent-cache.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+const std::string SnapshotFilePath = "persistent-cache_test.snapshot";
+
+class CountingCache : public mse::UnorderedMapCache
+{
+public:
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override
+  {
+    ++get_count;
+    return mse::UnorderedMapCache::GetShared(key);
+  }
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override
+  {
+    ++(std::this_thread::get_id() == creating_thread_id ? creating_thread_peek_count : other_thread_peek_count);
+    return mse::UnorderedMapCache::Peek(key);
+  }
+
+  const std::thread::id creating_thread_id = std::this_thread::get_id();
+  mutable std::atomic<std::size_t> get_count = 0;
+  mutable std::atomic<std::size_t> creating_thread_peek_count = 0;
+  mutable std::atomic<std::size_t> other_thread_peek_count = 0;
+};
+} // namespace
+
+SCENARIO("Persistent Cache", "[performance][caching]")
+{
+  std::remove(SnapshotFilePath.c_str());
+
+  GIVEN("a persistent cache with some elements")
+  {
+    const mse::Cache::TimePoint now = mse::Cache::Clock::now();
+    std::shared_ptr<mse::UnorderedMapCache> real_cache = std::make_shared<mse::UnorderedMapCache>();
+    mse::PersistentCache cache(real_cache, SnapshotFilePath);
+    cache.Insert("1", mse::Cache::Element{std::string("one"), mse::Status::OK, now, now + 1h, 3, {"a", "b"}});
+    cache.Insert("2", mse::Cache::Element{std::make_shared<const std::string>("two"),
+                                          mse::Status{mse::StatusCode::not_found, "details"}, now - 1s});
+    cache.Insert("3", mse::Cache::Element{std::string("three"), mse::Status::OK, now - 2s, now + 1ms});
+    cache.Insert("4", mse::Cache::Element{42, mse::Status::OK, now}); // cannot be serialized as a string
+    cache.Insert("5", mse::Cache::Element{std::string("five"), mse::Status::OK, now});
+    real_cache->Remove("5"); // e.g. evicted
+
+    WHEN("there is no snapshot yet")
+    {
+      THEN("nothing is loaded")
+      {
+        REQUIRE(cache.LoadSnapshot() == 0);
+      }
+    }
+
+    WHEN("a snapshot is saved and loaded into another cache after the short-lived element expired")
+    {
+      REQUIRE(cache.SaveSnapshot() == 3);
+      std::this_thread::sleep_for(5ms);
+      std::shared_ptr<mse::UnorderedMapCache> other_real_cache = std::make_shared<mse::UnorderedMapCache>();
+      mse::PersistentCache other_cache(other_real_cache, SnapshotFilePath);
+      const std::size_t loaded_count = other_cache.LoadSnapshot();
+
+      THEN("the elements that have not expired are restored")
+      {
+        REQUIRE(loaded_count == 2);
+
+        const mse::Cache::Element one = other_cache.Get("1");
+        REQUIRE(std::any_cast<std::string>(one.data) == "one");
+        REQUIRE(one.status.code == mse::StatusCode::ok);
+        REQUIRE(one.weight == 3);
+        REQUIRE(one.tags == std::vector<std::string>{"a", "b"});
+        REQUIRE(std::chrono::abs(one.insertion_time - now) < 100ms);
+        REQUIRE(std::chrono::abs(one.expiry_time - (now + 1h)) < 100ms);
+
+        const mse::Cache::Element two = other_cache.Get("2");
+        REQUIRE(std::any_cast<std::string>(two.data) == "two");
+        REQUIRE(two.status.code == mse::StatusCode::not_found);
+        REQUIRE(two.status.details == "details");
+        REQUIRE(two.expiry_time == mse::Cache::TimePoint::max());
+
+        REQUIRE(!other_cache.Get("3").data.has_value());
+        REQUIRE(!other_cache.Get("4").data.has_value());
+        REQUIRE(!other_cache.Get("5").data.has_value());
+      }
+      AND_THEN("the loaded elements are persisted by the next snapshot")
+      {
+        REQUIRE(other_cache.SaveSnapshot() == 2);
+      }
+    }
+
+    WHEN("periodic snapshots are started twice")
+    {
+      cache.StartPeriodicSnapshots(1h);
+      THEN("an exception is thrown")
+      {
+        REQUIRE_THROWS_AS(cache.StartPeriodicSnapshots(1h), std::logic_error);
+      }
+    }
+
+    WHEN("periodic snapshots are started")
+    {
+      cache.StartPeriodicSnapshots(1ms);
+      std::this_thread::sleep_for(50ms);
+      THEN("a snapshot is saved")
+      {
+        mse::PersistentCache other_cache(std::make_shared<mse::UnorderedMapCache>(), SnapshotFilePath);
+        REQUIRE(other_cache.LoadSnapshot() >= 2);
+      }
+    }
+  }
+
+  GIVEN("a persistent cache whose real cache drops most elements")
+  {
+    std::shared_ptr<CountingCache> real_cache = std::make_shared<CountingCache>();
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    real_cache->SetStatistics(statistics);
+    mse::PersistentCache cache(real_cache, SnapshotFilePath);
+
+    WHEN("many elements are inserted")
+    {
+      for (int i = 0; i < 10000; ++i)
+      {
+        const std::string key = std::to_string(i);
+        cache.Insert(key, mse::Cache::Element{key, mse::Status::OK, mse::Cache::Clock::now()});
+        if (i % 100 != 0)
+        {
+          real_cache->Remove(key); // e.g. evicted
+        }
+      }
+      const std::size_t inserting_thread_peek_count = real_cache->creating_thread_peek_count;
+      for (int i = 0; i < 500 && real_cache->other_thread_peek_count == 0; ++i)
+      {
+        std::this_thread::sleep_for(10ms);
+      }
+
+      THEN("the keys of the dropped elements are pruned in the background")
+      {
+        REQUIRE(inserting_thread_peek_count == 0);
+        REQUIRE(real_cache->other_thread_peek_count > 0);
+      }
+      AND_WHEN("snapshots are saved")
+      {
+        const std::size_t persisted_count = cache.SaveSnapshot();
+        real_cache->creating_thread_peek_count = 0;
+        cache.SaveSnapshot();
+        THEN("the real cache is inspected without side effects and only the remaining keys are tracked")
+        {
+          REQUIRE(persisted_count == 100);
+          REQUIRE(real_cache->creating_thread_peek_count == 100);
+          REQUIRE(real_cache->get_count == 0);
+          REQUIRE(statistics->GetSnapshot().hits == 0);
+          REQUIRE(statistics->GetSnapshot().misses == 0);
+        }
+      }
+    }
+  }
+
+  GIVEN("a corrupt snapshot")
+  {
+    {
+      std::ofstream file(SnapshotFilePath, std::ios::binary);
+      file << "MSECACHE";
+    }
+    mse::PersistentCache cache(std::make_shared<mse::UnorderedMapCache>(), SnapshotFilePath);
+
+    WHEN("it is loaded")
+    {
+      THEN("an exception is thrown")
+      {
+        REQUIRE_THROWS_AS(cache.LoadSnapshot(), std::runtime_error);
+      }
+    }
+  }
+
+  GIVEN("a file that is not a snapshot")
+  {
+    {
+      std::ofstream file(SnapshotFilePath, std::ios::binary);
+      file << "some other content";
+    }
+    mse::PersistentCache cache(std::make_shared<mse::UnorderedMapCache>(), SnapshotFilePath);
+
+    WHEN("it is loaded")
+    {
+      THEN("an exception is thrown")
+      {
+        REQUIRE_THROWS_AS(cache.LoadSnapshot(), std::runtime_error);
+      }
+    }
+  }
+
+  std::remove(SnapshotFilePath.c_str());
+}
@@ -0,0 +1,208 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <microservice-essentials/performance/tagged-cache.h>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+mse::Cache::Element create_element(int value, const std::vector<std::string>& tags)
+{
+  mse::Cache::Element element{value, mse::Status::OK, mse::Cache::Clock::now()};
+  element.tags = tags;
+  return element;
+}
+
+class PeekCountingCache : public mse::UnorderedMapCache
+{
+public:
+  virtual std::shared_ptr<const Element> Peek(const std::string& key) const override
+  {
+    ++peek_count;
+    return mse::UnorderedMapCache::Peek(key);
+  }
+
+  mutable std::size_t peek_count = 0;
+};
+} // namespace
+
+SCENARIO("Tagged Cache", "[performance][caching]")
+{
+  GIVEN("a tagged cache with elements of different tags and prefixes")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> real_cache = std::make_shared<mse::UnorderedMapCache>(4, 1ms);
+    mse::TaggedCache cache(real_cache);
+    cache.Insert("starships", create_element(0, {"starships"}));
+    cache.Insert("starship/1", create_element(1, {"starships", "starship/1"}));
+    cache.Insert("starship/2", create_element(2, {"starships", "starship/2"}));
+    cache.Insert("starship/20", create_element(20, {}));
+    cache.Insert("starshipyard", create_element(3, {}));
+
+    WHEN("a tag is invalidated")
+    {
+      const std::size_t invalidated_count = cache.InvalidateTag("starship/1");
+      THEN("only the elements with that tag are removed")
+      {
+        REQUIRE(invalidated_count == 1);
+        REQUIRE(!mse::Cache::IsValid(cache.Get("starship/1")));
+        REQUIRE(real_cache->GetShared("starship/1") == nullptr);
+        REQUIRE(std::any_cast<int>(cache.Get("starships").data) == 0);
+        REQUIRE(std::any_cast<int>(cache.Get("starship/2").data) == 2);
+      }
+      AND_THEN("the element's other tags do not include it anymore")
+      {
+        REQUIRE(cache.InvalidateTag("starships") == 2);
+      }
+    }
+
+    WHEN("a tag shared by several elements is invalidated")
+    {
+      const std::size_t invalidated_count = cache.InvalidateTag("starships");
+      THEN("all of them are removed")
+      {
+        REQUIRE(invalidated_count == 3);
+        REQUIRE(cache.GetShared("starships") == nullptr);
+        REQUIRE(cache.GetShared("starship/1") == nullptr);
+        REQUIRE(cache.GetShared("starship/2") == nullptr);
+        REQUIRE(cache.GetShared("starship/20") != nullptr);
+      }
+      AND_THEN("invalidating it again does nothing")
+      {
+        REQUIRE(cache.InvalidateTag("starships") == 0);
+      }
+    }
+
+    WHEN("an unknown tag is invalidated")
+    {
+      THEN("nothing is removed")
+      {
+        REQUIRE(cache.InvalidateTag("planets") == 0);
+        REQUIRE(cache.InvalidatePrefix("planet") == 0);
+      }
+    }
+
+    WHEN("a prefix is invalidated")
+    {
+      const std::size_t invalidated_count = cache.InvalidatePrefix("starship/");
+      THEN("only the elements whose keys start with the prefix are removed")
+      {
+        REQUIRE(invalidated_count == 3);
+        REQUIRE(cache.GetShared("starship/1") == nullptr);
+        REQUIRE(cache.GetShared("starship/2") == nullptr);
+        REQUIRE(cache.GetShared("starship/20") == nullptr);
+        REQUIRE(cache.GetShared("starships") != nullptr);
+        REQUIRE(cache.GetShared("starshipyard") != nullptr);
+      }
+      AND_THEN("their tags do not include them anymore")
+      {
+        REQUIRE(cache.InvalidateTag("starships") == 1);
+      }
+    }
+
+    WHEN("an element is replaced with different tags")
+    {
+      cache.Insert("starship/1", create_element(11, {"other"}));
+      THEN("only its new tags invalidate it")
+      {
+        REQUIRE(cache.InvalidateTag("starship/1") == 0);
+        REQUIRE(std::any_cast<int>(cache.Get("starship/1").data) == 11);
+        REQUIRE(cache.InvalidateTag("other") == 1);
+        REQUIRE(cache.GetShared("starship/1") == nullptr);
+      }
+    }
+
+    WHEN("an element is removed")
+    {
+      cache.Remove("starship/1");
+      THEN("its tags do not include it anymore")
+      {
+        REQUIRE(cache.InvalidateTag("starship/1") == 0);
+        REQUIRE(cache.InvalidateTag("starships") == 2);
+      }
+    }
+
+    WHEN("an element has expired in the real cache and is requested")
+    {
+      cache.Insert("expiring", mse::Cache::Element{4, mse::Status::OK, mse::Cache::Clock::now(),
+                                                   mse::Cache::Clock::now() + 1ms, 1, {"starships"}});
+      std::this_thread::sleep_for(5ms);
+      REQUIRE(!mse::Cache::IsValid(cache.Get("expiring")));
+      THEN("it is not counted by an invalidation")
+      {
+        REQUIRE(cache.InvalidateTag("starships") == 3);
+      }
+    }
+  }
+
+  GIVEN("a tagged cache above a bounded real cache")
+  {
+    std::shared_ptr<PeekCountingCache> counting_cache = std::make_shared<PeekCountingCache>();
+    std::shared_ptr<mse::LRUCache> real_cache = std::make_shared<mse::LRUCache>(counting_cache, 10);
+    std::shared_ptr<mse::CacheStatistics> statistics = std::make_shared<mse::CacheStatistics>();
+    real_cache->SetStatistics(statistics);
+    mse::TaggedCache cache(real_cache);
+
+    WHEN("many more elements than the real cache holds are inserted and never requested again")
+    {
+      for (int i = 0; i < 10000; ++i)
+      {
+        cache.Insert("starship/" + std::to_string(i), create_element(i, {"starships"}));
+      }
+      counting_cache->peek_count = 0;
+      const std::size_t invalidated_count = cache.InvalidateTag("starships");
+
+      THEN("the index of the evicted elements has been pruned in the meantime")
+      {
+        REQUIRE(invalidated_count == 10);
+        REQUIRE(counting_cache->peek_count < 2 * 1024); // one per indexed key
+        REQUIRE(cache.InvalidatePrefix("starship/") == 0);
+      }
+      AND_THEN("neither pruning nor counting has touched the statistics of the real cache")
+      {
+        REQUIRE(statistics->GetSnapshot().hits == 0);
+        REQUIRE(statistics->GetSnapshot().misses == 0);
+      }
+    }
+  }
+
+  GIVEN("a caching request hook with tags")
+  {
+    std::shared_ptr<mse::TaggedCache> cache =
+        std::make_shared<mse::TaggedCache>(std::make_shared<mse::UnorderedMapCache>());
+    int object = 0;
+    mse::Context context;
+    auto func = [&object](mse::Context&) {
+      object = 42;
+      return mse::Status::OK;
+    };
+
+    WHEN("a request is cached with constant tags")
+    {
+      mse::CachingRequestHook hook(
+          mse::CachingRequestHook::Parameters(cache).WithKey("1").WithCachedObject(object).WithTags({"a", "b"}));
+      hook.Process(func, context);
+      THEN("the element has the tags")
+      {
+        REQUIRE(cache->Get("1").tags == std::vector<std::string>{"a", "b"});
+        REQUIRE(cache->InvalidateTag("b") == 1);
+      }
+    }
+
+    WHEN("a request is cached with generated tags")
+    {
+      mse::CachingRequestHook hook(mse::CachingRequestHook::Parameters(cache)
+                                       .WithKey("1")
+                                       .WithCachedObject(object)
+                                       .WithTagGenerator([&object]() -> std::vector<std::string> {
+                                         return {"object/" + std::to_string(object)};
+                                       }));
+      hook.Process(func, context);
+      THEN("the tags are generated from the response")
+      {
+        REQUIRE(cache->InvalidateTag("object/42") == 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <microservice-essentials/performance/thread-local-cache.h>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+class CountingCache : public mse::UnorderedMapCache
+{
+public:
+  virtual std::shared_ptr<const Element> GetShared(const std::string& key) const override
+  {
+    ++get_count;
+    return mse::UnorderedMapCache::GetShared(key);
+  }
+
+  mutable std::size_t get_count = 0;
+};
+} // namespace
+
+SCENARIO("Thread Local Cache", "[performance][caching]")
+{
+  GIVEN("a thread local cache with an L1 capacity of 2")
+  {
+    std::shared_ptr<CountingCache> real_cache = std::make_shared<CountingCache>();
+    mse::ThreadLocalCache cache(real_cache, 2);
+    cache.Insert("1", mse::Cache::Element{1, mse::Status::OK, mse::Cache::Clock::now()});
+
+    WHEN("an element is requested repeatedly")
+    {
+      const int first = std::any_cast<int>(cache.Get("1").data);
+      const std::shared_ptr<const mse::Cache::Element> second = cache.GetShared("1");
+      THEN("only the first request reaches the real cache")
+      {
+        REQUIRE(first == 1);
+        REQUIRE(std::any_cast<int>(second->data) == 1);
+        REQUIRE(real_cache->get_count == 1);
+      }
+    }
+
+    WHEN("an element is replaced after it has been requested")
+    {
+      cache.Get("1");
+      cache.Insert("1", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now()});
+      THEN("the new element is returned")
+      {
+        REQUIRE(std::any_cast<int>(cache.Get("1").data) == 2);
+        REQUIRE(real_cache->get_count == 2);
+      }
+    }
+
+    WHEN("an element is removed after it has been requested")
+    {
+      cache.Get("1");
+      cache.Remove("1");
+      THEN("it is not returned anymore")
+      {
+        REQUIRE(cache.GetShared("1") == nullptr);
+      }
+    }
+
+    WHEN("an element is replaced by another thread")
+    {
+      cache.Get("1");
+      int other_thread_value = 0;
+      std::thread([&cache, &other_thread_value]() {
+        other_thread_value = std::any_cast<int>(cache.Get("1").data);
+        cache.Insert("1", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now()});
+      }).join();
+      THEN("this thread's L1 copy is outdated")
+      {
+        REQUIRE(other_thread_value == 1);
+        REQUIRE(std::any_cast<int>(cache.Get("1").data) == 2);
+      }
+    }
+
+    WHEN("more elements are requested than fit into L1")
+    {
+      cache.Insert("2", mse::Cache::Element{2, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Insert("3", mse::Cache::Element{3, mse::Status::OK, mse::Cache::Clock::now()});
+      cache.Get("1");
+      cache.Get("2");
+      cache.Get("1");
+      cache.Get("3"); // evicts "2" from L1
+      const std::size_t get_count = real_cache->get_count;
+      cache.Get("1");
+      cache.Get("3");
+      THEN("the least recently used element has been evicted from L1 only")
+      {
+        REQUIRE(real_cache->get_count == get_count);
+        REQUIRE(std::any_cast<int>(cache.Get("2").data) == 2);
+        REQUIRE(real_cache->get_count == get_count + 1);
+      }
+    }
+
+    WHEN("an element expires")
+    {
+      cache.Insert("4", mse::Cache::Element{4, mse::Status::OK, mse::Cache::Clock::now(),
+                                            mse::Cache::Clock::now() + 1ms});
+      REQUIRE(cache.GetShared("4") != nullptr);
+      std::this_thread::sleep_for(5ms);
+      THEN("it is not returned from L1 anymore")
+      {
+        REQUIRE(cache.GetShared("4") == nullptr);
+      }
+    }
+
+    WHEN("a missing element is requested")
+    {
+      THEN("it is not found")
+      {
+        REQUIRE(!mse::Cache::IsValid(cache.Get("5")));
+      }
+    }
+  }
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <microservice-essentials/performance/timing-wheel.h>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+SCENARIO("Timing Wheel", "[performance][caching]")
+{
+  GIVEN("a timing wheel with a resolution of 1ms")
+  {
+    const mse::TimingWheel::TimePoint start_time = mse::TimingWheel::Clock::now();
+    mse::TimingWheel wheel(1ms, start_time);
+    std::vector<std::string> expired_keys;
+    auto on_expired = [&expired_keys](const std::string& key) { expired_keys.push_back(key); };
+
+    WHEN("keys are scheduled")
+    {
+      wheel.Schedule("a", start_time + 10ms);
+      wheel.Schedule("b", start_time + 5ms);
+      REQUIRE(wheel.Size() == 2);
+
+      AND_WHEN("the wheel is advanced to before their expiry times")
+      {
+        wheel.Advance(start_time + 4ms, on_expired);
+
+        THEN("no key is reported")
+        {
+          REQUIRE(expired_keys.empty());
+          REQUIRE(wheel.Size() == 2);
+        }
+      }
+      AND_WHEN("the wheel is advanced step by step")
+      {
+        wheel.Advance(start_time + 5ms, on_expired);
+        const std::vector<std::string> expired_keys_after_5ms = expired_keys;
+        wheel.Advance(start_time + 10ms, on_expired);
+
+        THEN("each key is reported once its expiry time has passed")
+        {
+          REQUIRE(expired_keys_after_5ms == std::vector<std::string>{"b"});
+          REQUIRE(expired_keys == std::vector<std::string>{"b", "a"});
+          REQUIRE(wheel.Size() == 0);
+        }
+      }
+    }
+
+    WHEN("keys are scheduled beyond the range of the first levels")
+    {
+      const std::vector<std::chrono::milliseconds> expiry_delays = {63ms, 64ms, 65ms, 4095ms, 4096ms, 300000ms};
+      for (const auto& delay : expiry_delays)
+      {
+        wheel.Schedule(std::to_string(delay.count()), start_time + delay);
+      }
+
+      AND_WHEN("the wheel is advanced to shortly before and exactly at each expiry time")
+      {
+        std::vector<std::size_t> reported_counts;
+        for (const auto& delay : expiry_delays)
+        {
+          wheel.Advance(start_time + delay - 1ms, on_expired);
+          reported_counts.push_back(expired_keys.size());
+          wheel.Advance(start_time + delay, on_expired);
+          reported_counts.push_back(expired_keys.size());
+        }
+
+        THEN("each key is reported exactly at its expiry time")
+        {
+          REQUIRE(reported_counts == std::vector<std::size_t>{0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6});
+          REQUIRE(expired_keys == std::vector<std::string>{"63", "64", "65", "4095", "4096", "300000"});
+        }
+      }
+    }
+
+    WHEN("a key is scheduled with an expiry time that has already passed")
+    {
+      wheel.Advance(start_time + 10ms, on_expired);
+      wheel.Schedule("a", start_time + 5ms);
+      wheel.Advance(start_time + 11ms, on_expired);
+
+      THEN("it is reported with the next tick")
+      {
+        REQUIRE(expired_keys == std::vector<std::string>{"a"});
+      }
+    }
+
+    WHEN("a key is scheduled twice")
+    {
+      wheel.Schedule("a", start_time + 5ms);
+      wheel.Schedule("a", start_time + 7ms);
+      wheel.Advance(start_time + 10ms, on_expired);
+
+      THEN("it is reported twice")
+      {
+        REQUIRE(expired_keys == std::vector<std::string>{"a", "a"});
+      }
+    }
+  }
+}
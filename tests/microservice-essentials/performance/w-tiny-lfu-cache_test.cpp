@@ -0,0 +1,183 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <functional>
+#include <microservice-essentials/performance/w-tiny-lfu-cache.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+mse::Cache::Element create_element(int value)
+{
+  return mse::Cache::Element{value, mse::Status::OK, mse::Cache::Clock::now()};
+}
+
+// typical usage by the CachingRequestHook: get and insert on cache miss
+bool get_or_insert(mse::Cache& cache, const std::string& key)
+{
+  if (mse::Cache::IsValid(cache.Get(key)))
+  {
+    return true;
+  }
+  cache.Insert(key, create_element(0));
+  return false;
+}
+} // namespace
+
+SCENARIO("Frequency Sketch", "[performance][caching]")
+{
+  GIVEN("a frequency sketch for 16 keys")
+  {
+    mse::FrequencySketch sketch(16);
+    const std::uint64_t key_hash = std::hash<std::string>{}("key");
+    WHEN("a key is incremented 3 times")
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        sketch.Increment(key_hash);
+      }
+      THEN("its frequency is estimated to be 3")
+      {
+        REQUIRE(sketch.Estimate(key_hash) == 3);
+      }
+    }
+    WHEN("a key is incremented more often than the counters can count")
+    {
+      for (int i = 0; i < 20; ++i)
+      {
+        sketch.Increment(key_hash);
+      }
+      THEN("its frequency saturates at 15")
+      {
+        REQUIRE(sketch.Estimate(key_hash) == 15);
+      }
+    }
+    WHEN("many other keys are incremented")
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        sketch.Increment(key_hash);
+      }
+      for (int i = 0; i < 1000; ++i)
+      {
+        sketch.Increment(std::hash<std::string>{}(std::to_string(i)));
+      }
+      THEN("the key's frequency has been aged")
+      {
+        REQUIRE(sketch.Estimate(key_hash) < 4);
+      }
+    }
+  }
+}
+
+SCENARIO("W-TinyLFU Cache", "[performance][caching]")
+{
+  GIVEN("a W-TinyLFU cache with an unordered map cache as the backend and a capacity of 10 elements")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> real_cache = std::make_shared<mse::UnorderedMapCache>();
+    mse::WTinyLFUCache cache(real_cache, 10);
+    WHEN("an element is inserted")
+    {
+      cache.Insert("1", create_element(1));
+      THEN("the element can be retrieved")
+      {
+        auto element = cache.Get("1");
+        REQUIRE(mse::Cache::IsValid(element) == true);
+        REQUIRE(std::any_cast<int>(element.data) == 1);
+        REQUIRE(std::any_cast<int>(cache.GetShared("1")->data) == 1);
+      }
+
+      AND_WHEN("an element is removed")
+      {
+        cache.Remove("1");
+        THEN("the element cannot be retrieved")
+        {
+          REQUIRE(mse::Cache::IsValid(cache.Get("1")) == false);
+          REQUIRE(mse::Cache::IsValid(real_cache->Get("1")) == false);
+        }
+      }
+    }
+    WHEN("a non existing element is removed")
+    {
+      cache.Remove("1");
+      THEN("the element cannot be retrieved")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("1")) == false);
+      }
+    }
+    WHEN("an element that has been inserted into the backend directly is removed")
+    {
+      real_cache->Insert("1", create_element(1));
+      cache.Remove("1");
+      THEN("it is removed from the backend")
+      {
+        REQUIRE(mse::Cache::IsValid(real_cache->Get("1")) == false);
+      }
+    }
+    WHEN("more elements than the capacity are inserted")
+    {
+      for (int i = 0; i < 30; ++i)
+      {
+        get_or_insert(cache, std::to_string(i));
+      }
+      THEN("the backend holds at most the capacity")
+      {
+        int valid_count = 0;
+        for (int i = 0; i < 30; ++i)
+        {
+          valid_count += mse::Cache::IsValid(real_cache->Get(std::to_string(i)));
+        }
+        REQUIRE(valid_count <= 10);
+      }
+    }
+    WHEN("the backend drops expired elements that had been requested frequently")
+    {
+      for (int i = 0; i < 10; ++i)
+      {
+        cache.Insert("expiring" + std::to_string(i), mse::Cache::Element{i, mse::Status::OK, mse::Cache::Clock::now(),
+                                                                         mse::Cache::Clock::now() + 1ms});
+      }
+      std::this_thread::sleep_for(5ms);
+      for (int round = 0; round < 3; ++round)
+      {
+        for (int i = 0; i < 10; ++i)
+        {
+          cache.Get("expiring" + std::to_string(i));
+        }
+      }
+      for (int i = 0; i < 10; ++i)
+      {
+        get_or_insert(cache, std::to_string(i));
+      }
+      THEN("their entries do not occupy the capacity anymore")
+      {
+        for (int i = 0; i < 10; ++i)
+        {
+          REQUIRE(mse::Cache::IsValid(real_cache->Get(std::to_string(i))) == true);
+        }
+      }
+    }
+    WHEN("frequently requested elements are followed by a scan of elements that are requested once")
+    {
+      for (int round = 0; round < 5; ++round)
+      {
+        for (int i = 0; i < 8; ++i)
+        {
+          get_or_insert(cache, "hot" + std::to_string(i));
+        }
+      }
+      for (int i = 0; i < 30; ++i)
+      {
+        get_or_insert(cache, "scan" + std::to_string(i));
+      }
+      THEN("the frequently requested elements have not been displaced")
+      {
+        for (int i = 0; i < 8; ++i)
+        {
+          REQUIRE(mse::Cache::IsValid(cache.Get("hot" + std::to_string(i))) == true);
+        }
+      }
+    }
+  }
+}
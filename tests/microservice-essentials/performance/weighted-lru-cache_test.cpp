@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <microservice-essentials/performance/weighted-lru-cache.h>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+mse::Cache::Element create_element(const std::string& value)
+{
+  mse::Cache::Element element{value, mse::Status::OK, mse::Cache::Clock::now()};
+  element.weight = value.size();
+  return element;
+}
+} // namespace
+
+SCENARIO("Weighted LRU Cache", "[performance][caching]")
+{
+  GIVEN("a weighted LRU cache with a budget of 10")
+  {
+    std::shared_ptr<mse::UnorderedMapCache> real_cache = std::make_shared<mse::UnorderedMapCache>(4, 1ms);
+    mse::WeightedLRUCache cache(real_cache, 10);
+    REQUIRE(cache.GetMaxWeight() == 10);
+
+    WHEN("an element is inserted")
+    {
+      cache.Insert("1", create_element("abcd"));
+      THEN("the element can be retrieved and its weight is accounted")
+      {
+        REQUIRE(std::any_cast<std::string>(cache.Get("1").data) == "abcd");
+        REQUIRE(cache.GetShared("1") != nullptr);
+        REQUIRE(cache.GetWeight() == 4);
+      }
+
+      AND_WHEN("the element is replaced")
+      {
+        cache.Insert("1", create_element("ab"));
+        THEN("only the weight of the new element is accounted")
+        {
+          REQUIRE(std::any_cast<std::string>(cache.Get("1").data) == "ab");
+          REQUIRE(cache.GetWeight() == 2);
+        }
+      }
+      AND_WHEN("the element is removed")
+      {
+        cache.Remove("1");
+        THEN("the element cannot be retrieved and its weight is released")
+        {
+          REQUIRE(mse::Cache::IsValid(cache.Get("1")) == false);
+          REQUIRE(cache.GetWeight() == 0);
+        }
+      }
+    }
+
+    WHEN("the elements exceed the budget")
+    {
+      cache.Insert("1", create_element("aaaa"));
+      cache.Insert("2", create_element("bbbb"));
+      cache.Get("1"); // 1 is now the most recently used element, 2 the least recently used
+      cache.Insert("3", create_element("cccccc"));
+      THEN("the least recently used elements are evicted until the new element fits")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("1")) == true);
+        REQUIRE(mse::Cache::IsValid(cache.Get("2")) == false);
+        REQUIRE(mse::Cache::IsValid(cache.Get("3")) == true);
+        REQUIRE(cache.GetWeight() == 10);
+      }
+    }
+
+    WHEN("an element weighs more than the budget")
+    {
+      cache.Insert("1", create_element("aaaa"));
+      cache.Insert("2", create_element("bbbbbbbbbbb"));
+      THEN("it is not cached and does not evict other elements")
+      {
+        REQUIRE(mse::Cache::IsValid(cache.Get("1")) == true);
+        REQUIRE(mse::Cache::IsValid(cache.Get("2")) == false);
+        REQUIRE(cache.GetWeight() == 4);
+      }
+    }
+
+    WHEN("an element expires in the real cache")
+    {
+      mse::Cache::Element element = create_element("aaaa");
+      element.expiry_time = mse::Cache::Clock::now() + 5ms;
+      cache.Insert("1", element);
+      std::this_thread::sleep_for(10ms);
+      THEN("its weight is released when it is requested")
+      {
+        REQUIRE(cache.GetShared("1") == nullptr);
+        REQUIRE(cache.GetWeight() == 0);
+      }
+    }
+  }
+}
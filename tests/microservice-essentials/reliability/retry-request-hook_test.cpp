@@ -1,7 +1,9 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <cmath>
+#include <future>
 #include <microservice-essentials/reliability/retry-request-hook.h>
+#include <microservice-essentials/utilities/executor.h>
 
 using namespace std::chrono_literals;
 
@@ -262,3 +264,64 @@ SCENARIO("Retry Request Hook", "[reliability][retry][request-hook]")
     }
   }
 }
+
+SCENARIO("Asynchronous Retry Request Hook", "[reliability][retry][request-hook]")
+{
+  std::shared_ptr<mse::Executor> executor = std::make_shared<mse::ThreadPoolExecutor>(1);
+
+  GIVEN("a retry request hook with linear backoff for 3 attempts for unavailable error code and an executor")
+  {
+    std::unique_ptr<mse::RequestHook> retry_request_hook = mse::RequestHookFactory::GetInstance().Create(
+        mse::RetryRequestHook::Parameters(std::make_shared<mse::LinearRetryBackoff>(3, 10ms),
+                                          {mse::StatusCode::unavailable})
+            .WithExecutor(executor));
+
+    WHEN("it asynchronously processes a function returning unavailable")
+    {
+      std::atomic<int> call_count = 0;
+      mse::Context ctx;
+      std::promise<mse::Status> result;
+      auto start_time = std::chrono::system_clock::now();
+      retry_request_hook->ProcessAsync(
+          [&](mse::Context&, mse::RequestHook::Continuation continuation) {
+            ++call_count;
+            continuation(mse::Status{mse::StatusCode::unavailable, ""});
+          },
+          ctx, [&](mse::Status status) { result.set_value(status); });
+      const auto return_duration = std::chrono::system_clock::now() - start_time;
+
+      THEN("the call returns without waiting for the retries")
+      {
+        REQUIRE(return_duration < 30ms);
+      }
+      AND_THEN("status is unavailable after four calls and at least 30ms")
+      {
+        std::future<mse::Status> status = result.get_future();
+        REQUIRE(status.wait_for(1s) == std::future_status::ready);
+        REQUIRE(status.get().code == mse::StatusCode::unavailable);
+        REQUIRE(call_count == 4);
+        REQUIRE(std::chrono::system_clock::now() - start_time >= 30ms);
+      }
+    }
+
+    WHEN("it asynchronously processes a function that succeeds on the second attempt")
+    {
+      std::atomic<int> call_count = 0;
+      mse::Context ctx;
+      std::promise<mse::Status> result;
+      retry_request_hook->ProcessAsync(
+          [&](mse::Context&, mse::RequestHook::Continuation continuation) {
+            continuation(++call_count == 1 ? mse::Status{mse::StatusCode::unavailable, ""} : mse::Status::OK);
+          },
+          ctx, [&](mse::Status status) { result.set_value(status); });
+
+      THEN("status is ok after two calls")
+      {
+        std::future<mse::Status> status = result.get_future();
+        REQUIRE(status.wait_for(1s) == std::future_status::ready);
+        REQUIRE(status.get());
+        REQUIRE(call_count == 2);
+      }
+    }
+  }
+}
@@ -0,0 +1,159 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <microservice-essentials/observability/logger.h>
+#include <microservice-essentials/request/request-hook-factory.h>
+#include <microservice-essentials/request/request-processor.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+typedef std::vector<std::pair<std::string, std::string>> CallHistory; // hook name, function name
+
+class RecordingRequestHook : public mse::RequestHook
+{
+public:
+  struct Parameters
+  {
+    std::string name;
+    CallHistory& call_history;
+    std::mutex& mutex;
+  };
+
+  static std::atomic<int> constructions;
+
+  RecordingRequestHook(const Parameters& parameters)
+      : mse::RequestHook(parameters.name), _call_history(parameters.call_history), _mutex(parameters.mutex)
+  {
+    ++constructions;
+  }
+
+  virtual mse::Status pre_process(mse::Context& context) override
+  {
+    std::lock_guard lock(_mutex);
+    _call_history.push_back({_name, std::string("pre ") + context.AtOr(mse::ContextKey::request, "")});
+    return mse::Status::OK;
+  }
+
+  virtual mse::Status post_process(mse::Context& /*context*/, mse::Status status) override
+  {
+    std::lock_guard lock(_mutex);
+    _call_history.push_back({_name, "post"});
+    return status;
+  }
+
+private:
+  CallHistory& _call_history;
+  std::mutex& _mutex;
+};
+
+std::atomic<int> RecordingRequestHook::constructions = 0;
+
+} // namespace
+
+SCENARIO("RequestPipeline", "[request]")
+{
+  mse::ConsoleLogger logger(mse::LogLevel::trace);
+  CallHistory call_history;
+  std::mutex mutex;
+  mse::RequestHookFactory::GetInstance().Clear();
+  mse::RequestHookFactory::GetInstance().Register<RecordingRequestHook::Parameters>(
+      mse::AutoRequestHookParameterRegistration<RecordingRequestHook::Parameters, RecordingRequestHook>::Create);
+
+  GIVEN("a pipeline built for incoming requests with a global hook")
+  {
+    mse::RequestHandler::GloballyWith(RecordingRequestHook::Parameters{"global", call_history, mutex});
+    mse::RequestPipeline pipeline = mse::RequestHandler::BuildPipeline("test");
+    mse::RequestHandler::ClearGlobalHooks();
+    pipeline.With(RecordingRequestHook::Parameters{"b", call_history, mutex})
+        .BeginWith(RecordingRequestHook::Parameters{"a", call_history, mutex});
+
+    WHEN("some function is processed")
+    {
+      std::string thread_local_value;
+      mse::Status status = pipeline.Process(
+          [&](mse::Context&) {
+            call_history.push_back({"func", "func"});
+            thread_local_value = mse::Context::GetThreadLocalContext().AtOr("key", "");
+            return mse::Status::OK;
+          },
+          mse::Context({{"key", "value"}}));
+
+      THEN("execution has been successful")
+      {
+        REQUIRE(status);
+      }
+      AND_THEN("the execution order is the same as for a RequestHandler")
+      {
+        REQUIRE(call_history.size() == 7);
+        REQUIRE((call_history[0].first == "a" && call_history[0].second == "pre test"));
+        REQUIRE((call_history[1].first == "global" && call_history[1].second == "pre test"));
+        REQUIRE((call_history[2].first == "b" && call_history[2].second == "pre test"));
+        REQUIRE((call_history[3].first == "func" && call_history[3].second == "func"));
+        REQUIRE((call_history[4].first == "b" && call_history[4].second == "post"));
+        REQUIRE((call_history[5].first == "global" && call_history[5].second == "post"));
+        REQUIRE((call_history[6].first == "a" && call_history[6].second == "post"));
+      }
+      AND_THEN("the given context has been the thread local context during processing")
+      {
+        REQUIRE(thread_local_value == "value");
+        REQUIRE_FALSE(mse::Context::GetThreadLocalContext().Contains("key"));
+      }
+    }
+
+    WHEN("requests are processed concurrently")
+    {
+      const int constructions_before = RecordingRequestHook::constructions;
+      std::atomic<int> processed_count = 0;
+      std::vector<std::thread> threads;
+      for (int i = 0; i < 4; ++i)
+      {
+        threads.emplace_back([&]() {
+          for (int j = 0; j < 100; ++j)
+          {
+            pipeline.Process(
+                [&](mse::Context&) {
+                  ++processed_count;
+                  return mse::Status::OK;
+                },
+                mse::Context());
+          }
+        });
+      }
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+
+      THEN("all requests have been processed by all hooks without creating new hooks")
+      {
+        REQUIRE(processed_count == 400);
+        REQUIRE(call_history.size() == 400 * 6);
+        REQUIRE(RecordingRequestHook::constructions == constructions_before);
+      }
+    }
+  }
+
+  GIVEN("a pipeline built for outgoing requests")
+  {
+    mse::RequestPipeline pipeline = mse::RequestIssuer::BuildPipeline("test");
+
+    WHEN("some function is processed")
+    {
+      mse::Status status =
+          pipeline.Process([&](mse::Context&) { return mse::Status{mse::StatusCode::not_found, ""}; },
+                           mse::Context({{"key", "value"}}));
+
+      THEN("the function's status is returned")
+      {
+        REQUIRE(status.code == mse::StatusCode::not_found);
+      }
+      AND_THEN("the given context is not installed as the thread local context")
+      {
+        REQUIRE_FALSE(mse::Context::GetThreadLocalContext().Contains("key"));
+      }
+    }
+  }
+  mse::RequestHookFactory::GetInstance().Clear();
+}
@@ -1,7 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
+#include <future>
 #include <microservice-essentials/observability/logger.h>
 #include <microservice-essentials/request/request-hook-factory.h>
 #include <microservice-essentials/request/request-processor.h>
+#include <microservice-essentials/utilities/executor.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 
 namespace
 {
@@ -255,6 +260,10 @@ SCENARIO("RequestProcessor", "[request]")
       {
         REQUIRE(request_type == mse::RequestType::incoming);
       }
+      AND_THEN("the meta data is not availble for the thread anymore")
+      {
+        REQUIRE(!mse::Context::GetThreadLocalContext().Contains("a"));
+      }
     }
   }
   GIVEN("a request issuer with a non empty context")
@@ -278,4 +287,120 @@ SCENARIO("RequestProcessor", "[request]")
     }
   }
   mse::Context::GetThreadLocalContext().Clear();
-}
\ No newline at end of file
+}
+SCENARIO("Asynchronous RequestProcessor", "[request]")
+{
+  using namespace std::chrono_literals;
+  DummyRequestHook::CallHistory call_history;
+  std::mutex mutex;
+  mse::ThreadPoolExecutor executor(2);
+
+  GIVEN("a request issuer with two successful hooks")
+  {
+    mse::RequestIssuer issuer("test", mse::Context());
+    issuer.With(std::make_unique<DummyRequestHook>("a", mse::StatusCode::ok, mse::StatusCode::ok, call_history))
+        .With(std::make_unique<DummyRequestHook>("b", mse::StatusCode::ok, mse::StatusCode::ok, call_history));
+
+    WHEN("a function that continues on another thread is processed asynchronously")
+    {
+      std::future<mse::Status> result =
+          issuer.ProcessAsync([&](mse::Context& context, mse::RequestHook::Continuation continuation) {
+            call_history.push_back({"func", context.AtOr(mse::ContextKey::request, "")});
+            executor.PostAfter(10ms, [&mutex, &call_history, continuation]() {
+              {
+                std::lock_guard lock(mutex);
+                call_history.push_back({"func", "continuation"});
+              }
+              continuation(mse::Status{mse::StatusCode::not_found, ""});
+            });
+          });
+
+      THEN("the result becomes ready with the function's status")
+      {
+        REQUIRE(result.wait_for(1s) == std::future_status::ready);
+        REQUIRE(result.get().code == mse::StatusCode::not_found);
+
+        AND_THEN("the execution order is the same as for synchronous processing")
+        {
+          std::lock_guard lock(mutex);
+          REQUIRE(call_history.size() == 6);
+          REQUIRE((call_history[0].first == "a" && call_history[0].second == "pre"));
+          REQUIRE((call_history[1].first == "b" && call_history[1].second == "pre"));
+          REQUIRE((call_history[2].first == "func" && call_history[2].second == "test"));
+          REQUIRE((call_history[3].first == "func" && call_history[3].second == "continuation"));
+          REQUIRE((call_history[4].first == "b" && call_history[4].second == "post"));
+          REQUIRE((call_history[5].first == "a" && call_history[5].second == "post"));
+        }
+      }
+    }
+
+    WHEN("a function that throws an exception is processed asynchronously")
+    {
+      std::future<mse::Status> result = issuer.ProcessAsync(
+          [](mse::Context&, mse::RequestHook::Continuation) { throw std::runtime_error("request failed"); });
+
+      THEN("the exception is stored in the result")
+      {
+        REQUIRE(result.wait_for(1s) == std::future_status::ready);
+        REQUIRE_THROWS_AS(result.get(), std::runtime_error);
+      }
+    }
+  }
+
+  GIVEN("a request that is issued asynchronously within the thread local scope of a handler's context")
+  {
+    std::promise<void> handler_returned;
+    std::promise<std::string> continued_value;
+    std::future<mse::Status> result;
+    {
+      auto handler_context = std::make_unique<mse::Context>(mse::Context::Metadata{{"handler-key", "handler-value"}},
+                                                            &mse::Context::GetGlobalContext());
+      mse::Context::ThreadLocalScope scope(*handler_context);
+      mse::RequestIssuer issuer("test", mse::Context()); // the thread local context, i.e. the handler's, is its parent
+      std::shared_future<void> handler_returned_future = handler_returned.get_future().share();
+      result = issuer.ProcessAsync([&](mse::Context& context, mse::RequestHook::Continuation continuation) {
+        executor.Post([&context, &continued_value, handler_returned_future, continuation]() {
+          handler_returned_future.wait();
+          continued_value.set_value(context.AtOr("handler-key", "missing"));
+          continuation(mse::Status::OK);
+        });
+      });
+    }
+    handler_returned.set_value();
+
+    WHEN("the request continues on another thread after the handler's context has been destroyed")
+    {
+      THEN("the continuation still sees the handler's metadata")
+      {
+        REQUIRE(result.wait_for(1s) == std::future_status::ready);
+        REQUIRE(continued_value.get_future().get() == "handler-value");
+      }
+    }
+  }
+
+  WHEN("many requests that wait for their responses without blocking are processed asynchronously")
+  {
+    const int request_count = 2000;
+    mse::RequestType request_type = mse::RequestType::invalid;
+    std::vector<std::future<mse::Status>> results;
+    const auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < request_count; ++i)
+    {
+      results.push_back(mse::RequestIssuer("test", mse::Context())
+                            .With(std::make_unique<RememberCallTypeRequestHook>(request_type))
+                            .ProcessAsync([&](mse::Context&, mse::RequestHook::Continuation continuation) {
+                              executor.PostAfter(50ms, [continuation]() { continuation(mse::Status::OK); });
+                            }));
+    }
+
+    THEN("two threads are sufficient to complete all requests concurrently")
+    {
+      for (std::future<mse::Status>& result : results)
+      {
+        REQUIRE(result.wait_for(5s) == std::future_status::ready);
+        REQUIRE(result.get());
+      }
+      REQUIRE(std::chrono::steady_clock::now() - start_time < 2s);
+    }
+  }
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch_test_macros.hpp>
+#include <microservice-essentials/cross-cutting-concerns/exception-handling-request-hook.h>
+#include <microservice-essentials/observability/logger.h>
+#include <microservice-essentials/request/static-pipeline.h>
+#include <stdexcept>
+
+namespace
+{
+typedef std::vector<std::pair<std::string, std::string>> CallHistory; // hook name, function name
+
+template <int Tag> class RecordingRequestHook : public mse::RequestHook
+{
+public:
+  struct Parameters
+  {
+    std::string name;
+    mse::StatusCode preprocess_status_code;
+    CallHistory& call_history;
+  };
+
+  RecordingRequestHook(const Parameters& parameters)
+      : mse::RequestHook(parameters.name), _preprocess_status_code(parameters.preprocess_status_code),
+        _call_history(parameters.call_history)
+  {
+  }
+
+  virtual mse::Status pre_process(mse::Context& context) override
+  {
+    _call_history.push_back({_name, "pre"});
+    _request_type = GetRequestType();
+    _request_name = context.AtOr(mse::ContextKey::request, "");
+    return mse::Status{_preprocess_status_code, ""};
+  }
+
+  virtual mse::Status post_process(mse::Context& /*context*/, mse::Status status) override
+  {
+    _call_history.push_back({_name, "post"});
+    return status;
+  }
+
+  mse::RequestType _request_type = mse::RequestType::invalid;
+  std::string _request_name;
+
+private:
+  mse::StatusCode _preprocess_status_code;
+  CallHistory& _call_history;
+};
+
+typedef RecordingRequestHook<1> HookA;
+typedef RecordingRequestHook<2> HookB;
+
+} // namespace
+
+SCENARIO("StaticPipeline", "[request]")
+{
+  mse::ConsoleLogger logger(mse::LogLevel::trace);
+  CallHistory call_history;
+
+  GIVEN("a static pipeline with two successful hooks")
+  {
+    mse::StaticPipeline<HookA, HookB> pipeline("test", mse::RequestType::incoming, mse::Context({{"key", "value"}}),
+                                               HookA::Parameters{"a", mse::StatusCode::ok, call_history},
+                                               HookB::Parameters{"b", mse::StatusCode::ok, call_history});
+
+    WHEN("some function is processed")
+    {
+      std::string thread_local_value;
+      mse::Status status = pipeline.Process([&](mse::Context&) {
+        call_history.push_back({"func", "func"});
+        thread_local_value = mse::Context::GetThreadLocalContext().AtOr("key", "");
+        return mse::Status::OK;
+      });
+
+      THEN("execution has been successful")
+      {
+        REQUIRE(status);
+      }
+      AND_THEN("the execution order is the same as for a RequestProcessor")
+      {
+        REQUIRE(call_history.size() == 5);
+        REQUIRE((call_history[0].first == "a" && call_history[0].second == "pre"));
+        REQUIRE((call_history[1].first == "b" && call_history[1].second == "pre"));
+        REQUIRE((call_history[2].first == "func" && call_history[2].second == "func"));
+        REQUIRE((call_history[3].first == "b" && call_history[3].second == "post"));
+        REQUIRE((call_history[4].first == "a" && call_history[4].second == "post"));
+      }
+      AND_THEN("the hooks know the request type and name")
+      {
+        REQUIRE(pipeline.GetHook<HookA>()._request_type == mse::RequestType::incoming);
+        REQUIRE(pipeline.GetHook<HookB>()._request_name == "test");
+      }
+      AND_THEN("the pipeline's context has been the thread local context during processing")
+      {
+        REQUIRE(thread_local_value == "value");
+        REQUIRE_FALSE(mse::Context::GetThreadLocalContext().Contains("key"));
+      }
+    }
+  }
+
+  GIVEN("a static pipeline with a failing first hook")
+  {
+    mse::StaticPipeline<HookA, HookB> pipeline("test", mse::RequestType::outgoing, mse::Context(),
+                                               HookA::Parameters{"a", mse::StatusCode::unavailable, call_history},
+                                               HookB::Parameters{"b", mse::StatusCode::ok, call_history});
+
+    WHEN("some function is processed")
+    {
+      mse::Status status = pipeline.Process([&](mse::Context&) {
+        call_history.push_back({"func", "func"});
+        return mse::Status::OK;
+      });
+
+      THEN("neither the following hooks nor the function have been executed")
+      {
+        REQUIRE(status.code == mse::StatusCode::unavailable);
+        REQUIRE(call_history.size() == 1);
+        REQUIRE((call_history[0].first == "a" && call_history[0].second == "pre"));
+      }
+    }
+  }
+
+  GIVEN("a static pipeline with a hook that overrides Process")
+  {
+    mse::StaticPipeline<mse::ExceptionHandlingRequestHook, HookA> pipeline(
+        "test", mse::RequestType::incoming, mse::Context(), mse::ExceptionHandlingRequestHook::Parameters(),
+        HookA::Parameters{"a", mse::StatusCode::ok, call_history});
+
+    WHEN("the function throws an exception")
+    {
+      mse::Status status = pipeline.Process([&](mse::Context&) -> mse::Status {
+        call_history.push_back({"func", "func"});
+        throw std::invalid_argument("invalid");
+      });
+
+      THEN("the exception is handled by the outer hook after post processing by the inner hook")
+      {
+        REQUIRE(status.code == mse::StatusCode::invalid_argument);
+        REQUIRE(call_history.size() == 3);
+        REQUIRE((call_history[2].first == "a" && call_history[2].second == "post"));
+      }
+    }
+  }
+}
@@ -0,0 +1,91 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <microservice-essentials/utilities/executor.h>
+#include <mutex>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+SCENARIO("ThreadPoolExecutor", "[executor]")
+{
+  GIVEN("a thread pool executor with two threads")
+  {
+    mse::ThreadPoolExecutor executor(2);
+
+    WHEN("a task is posted")
+    {
+      std::promise<std::thread::id> executing_thread;
+      executor.Post([&]() { executing_thread.set_value(std::this_thread::get_id()); });
+
+      THEN("the task is executed on a worker thread")
+      {
+        std::future<std::thread::id> result = executing_thread.get_future();
+        REQUIRE(result.wait_for(1s) == std::future_status::ready);
+        REQUIRE(result.get() != std::this_thread::get_id());
+      }
+    }
+
+    WHEN("tasks are posted with different delays")
+    {
+      std::mutex mutex;
+      std::vector<int> order;
+      std::promise<void> done;
+      executor.PostAfter(40ms, [&]() {
+        std::lock_guard lock(mutex);
+        order.push_back(2);
+        done.set_value();
+      });
+      executor.PostAfter(20ms, [&]() {
+        std::lock_guard lock(mutex);
+        order.push_back(1);
+      });
+      executor.Post([&]() {
+        std::lock_guard lock(mutex);
+        order.push_back(0);
+      });
+
+      THEN("they are executed in the order of their due times")
+      {
+        REQUIRE(done.get_future().wait_for(1s) == std::future_status::ready);
+        std::lock_guard lock(mutex);
+        REQUIRE(order == std::vector<int>{0, 1, 2});
+      }
+    }
+
+    WHEN("many more delayed tasks than threads are posted")
+    {
+      const int task_count = 1000;
+      std::atomic<int> executed_count = 0;
+      std::promise<void> done;
+      const auto start_time = std::chrono::steady_clock::now();
+      for (int i = 0; i < task_count; ++i)
+      {
+        executor.PostAfter(50ms, [&]() {
+          if (++executed_count == task_count)
+          {
+            done.set_value();
+          }
+        });
+      }
+
+      THEN("waiting tasks do not block the threads")
+      {
+        REQUIRE(done.get_future().wait_for(5s) == std::future_status::ready);
+        REQUIRE(std::chrono::steady_clock::now() - start_time < 1s);
+      }
+    }
+
+    WHEN("a task throws an exception")
+    {
+      std::promise<void> done;
+      executor.Post([]() { throw std::runtime_error("task failed"); });
+      executor.Post([&]() { done.set_value(); });
+
+      THEN("the executor continues to execute tasks")
+      {
+        REQUIRE(done.get_future().wait_for(1s) == std::future_status::ready);
+      }
+    }
+  }
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_all.hpp>
+#include <map>
 #include <microservice-essentials/utilities/metadata-converter.h>
 #include <string_view>
 
@@ -125,4 +126,20 @@ SCENARIO("Metadata converter", "[metadata][context]")
       }
     }
   }
+
+  GIVEN("some context with a parent")
+  {
+    const mse::Context parent({{"a", "x"}, {"b", "y"}}, nullptr);
+    const mse::Context context({{"a", "z"}, {"c", "w"}}, &parent);
+    WHEN("a subset of its metadata is converted to some multimap")
+    {
+      const ExternalMetadata external_metadata = mse::FromContextMetadata<ExternalMetadata>(context, {"a", "b"});
+      THEN("the result contains the requested elements of the context and its parent")
+      {
+        REQUIRE(external_metadata.size() == 2);
+        REQUIRE(external_metadata.find("a")->second == "z");
+        REQUIRE(external_metadata.find("b")->second == "y");
+      }
+    }
+  }
 }
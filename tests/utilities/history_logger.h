@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <microservice-essentials/observability/logger.h>
 
 namespace mse_test